@@ -0,0 +1,102 @@
+// Urgent command latency while the bulk lane is flooded: the blocking sendControlCommand
+// serializes every sender on one mutex, the urgent lane has a worker reserved for it.
+#include "CommunicationInterface.h"
+#include "AESCBCSecurity.h"
+#include "LoopbackTransport.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::string preSharedKeyHex = "00112233445566778899AABBCCDDEEFF";
+const int kBulkSenders = 4;
+const int kSamples = 2000;
+const auto kSampleInterval = std::chrono::microseconds(500);
+
+struct Percentiles {
+    double p50;
+    double p99;
+    double p999;
+    double max;
+};
+
+// Floods bulk traffic from kBulkSenders threads and times kSamples STOP commands, in microseconds
+template <typename SendBulk, typename SendUrgent>
+Percentiles measure(SendBulk sendBulk, SendUrgent sendUrgent) {
+    std::atomic<bool> flooding{true};
+    std::vector<std::thread> senders;
+    for (int i = 0; i < kBulkSenders; ++i) {
+        senders.emplace_back([&flooding, &sendBulk]() {
+            DataPacket::Command configure{"CONFIGURE", 10, 1000};
+            while (flooding) {
+                sendBulk(configure);
+            }
+        });
+    }
+
+    DataPacket::Command stop{"STOP", 0, 1};
+    std::vector<double> latencies;
+    latencies.reserve(kSamples);
+    for (int i = 0; i < kSamples; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        sendUrgent(stop);
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        std::this_thread::sleep_for(kSampleInterval);
+    }
+
+    flooding = false;
+    for (auto& sender : senders) {
+        sender.join();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double fraction) {
+        return latencies[std::min(latencies.size() - 1, static_cast<std::size_t>(fraction * latencies.size()))];
+    };
+    return {at(0.50), at(0.99), at(0.999), latencies.back()};
+}
+
+void print(const std::string& label, const Percentiles& result) {
+    std::cout << "  " << label << " p50 " << result.p50 << "  p99 " << result.p99
+              << "  p99.9 " << result.p999 << "  max " << result.max << " us\n";
+}
+
+} // namespace
+
+int main() {
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    device->setReadableCallback([&device]() {
+        std::string frame;
+        while (device->receive(frame)) {
+        }
+    });
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+
+    // The bulk path echoes every command; send it to /dev/null so the writes still happen
+    std::ofstream devNull("/dev/null");
+    std::streambuf* console = std::cout.rdbuf(devNull.rdbuf());
+
+    Percentiles shared = measure(
+        [&comm](const DataPacket::Command& command) { comm.sendControlCommand("bulkDevice", command); },
+        [&comm](const DataPacket::Command& command) { comm.sendControlCommand("stopDevice", command); });
+    Percentiles lanes = measure(
+        [&comm](const DataPacket::Command& command) { comm.sendControlCommand("bulkDevice", command, CommandPriority::Bulk); },
+        [&comm](const DataPacket::Command& command) { comm.sendControlCommand("stopDevice", command, CommandPriority::Urgent); });
+
+    std::cout.rdbuf(console);
+    device->setReadableCallback(nullptr);
+    std::cout << "STOP latency over " << kSamples << " samples with " << kBulkSenders << " threads flooding bulk sends\n";
+    std::cout << std::fixed << std::setprecision(1);
+    print("single mutex :", shared);
+    print("urgent lane  :", lanes);
+    return 0;
+}
@@ -0,0 +1,94 @@
+// Command throughput of the sharded interface as shards are added: each shard owns its
+// transport endpoint, cipher and reactor thread, so throughput should grow with the core count.
+#include "ShardedCommunicationInterface.h"
+#include "AESCBCSecurity.h"
+#include "LoopbackTransport.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const std::string preSharedKeyHex = "00112233445566778899AABBCCDDEEFF";
+const std::size_t kDevicesPerShard = 8;
+const int kCommandsPerShard = 20000;
+
+// Sends kCommandsPerShard commands per shard, one caller thread per shard, and returns commands per second
+double measure(std::size_t shardCount) {
+    std::vector<std::unique_ptr<LoopbackTransport>> devices;
+    ShardedCommunicationInterface comm(
+        shardCount, [](std::size_t) { return std::make_unique<AESCBCSecurity>(preSharedKeyHex); },
+        [&devices](std::size_t) {
+            auto endpoints = LoopbackTransport::createPair();
+            devices.push_back(std::move(endpoints.second));
+            return std::move(endpoints.first);
+        });
+    // Devices discard the commands they receive
+    for (auto& device : devices) {
+        LoopbackTransport* endpoint = device.get();
+        endpoint->setReadableCallback([endpoint]() {
+            std::string frame;
+            while (endpoint->receive(frame)) {
+            }
+        });
+    }
+
+    // Pick device IDs owned by each shard, so every caller keeps one shard busy
+    std::vector<std::vector<std::string>> owned(shardCount);
+    std::size_t filled = 0;
+    for (int i = 0; filled < shardCount; ++i) {
+        std::string deviceId = "device" + std::to_string(i);
+        auto& ids = owned[comm.shardOf(deviceId)];
+        if (ids.size() < kDevicesPerShard) {
+            ids.push_back(deviceId);
+            filled += ids.size() == kDevicesPerShard ? 1 : 0;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> callers;
+    for (std::size_t shard = 0; shard < shardCount; ++shard) {
+        callers.emplace_back([&comm, &ids = owned[shard]]() {
+            DataPacket::Command command{"MOVE", 10, 1};
+            for (int i = 0; i < kCommandsPerShard; ++i) {
+                comm.sendControlCommand(ids[i % ids.size()], command);
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (auto& device : devices) {
+        device->setReadableCallback(nullptr);
+    }
+    return static_cast<double>(kCommandsPerShard * shardCount) / seconds;
+}
+
+} // namespace
+
+int main() {
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Sharded command throughput, " << kCommandsPerShard << " commands per shard, " << cores << " cores\n";
+    std::cout << std::fixed << std::setprecision(1);
+
+    // Warm up caches and the allocator before timing
+    measure(1);
+
+    double single = 0;
+    for (std::size_t shards = 1; shards <= cores; shards *= 2) {
+        double throughput = measure(shards);
+        if (shards == 1) {
+            single = throughput;
+        }
+        std::cout << "  " << std::setw(3) << shards << " shards : " << std::setw(10) << throughput
+                  << " commands/s  (" << throughput / single << "x)\n";
+    }
+    return 0;
+}
@@ -3,29 +3,54 @@
 #define AESCBCC_SECURITY_H
 
 #include "ISecurity.h"
+#include "Executor.h"
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <cryptopp/filters.h>
 #include <cryptopp/osrng.h>
 #include <cryptopp/hex.h>
 #include <string>
+#include <cstddef>
+#include <memory>
 
 /**
  * @brief AES-CBC encryption and decryption implementation.
+ *
+ * CBC decryption has no dependency between blocks, so decryptBatch runs the blocks of
+ * every frame through pipelined ECB passes and applies the CBC chaining afterwards. Short
+ * frames are gathered into one pass; longer ones are read in place from their views.
+ * Authentication tags are truncated HMAC-SHA256 under a key derived from the pre-shared key with HKDF.
  */
 class AESCBCSecurity : public ISecurity {
 public:
  
-    AESCBCSecurity(const std::string& keyHex);
+    /**
+     * @param keyHex The pre-shared key as a hexadecimal string.
+     * @param batchWorkers Threads used to split large decryptBatch calls; 1 keeps them on the caller's thread.
+     *        The caller's thread takes one share, the other batchWorkers - 1 are started once here.
+     */
+    AESCBCSecurity(const std::string& keyHex, std::size_t batchWorkers = 1);
     ~AESCBCSecurity();
 
 
     std::string encrypt(const std::string& plainText) override;
 
-    std::string decrypt(const std::string& cipherText) override;
+    std::string decrypt(std::string_view cipherText) override;
+
+    std::vector<std::string> decryptBatch(const std::vector<std::string_view>& cipherTexts) override;
+
+    std::string authenticate(std::string_view message) override;
+
+    bool verify(std::string_view message, std::string_view tag) override;
 
 private:
+    static constexpr std::size_t kParallelBatchBytes = 64 * 1024; // Smaller batches are not worth a thread hop
+    static constexpr std::size_t kDirectFrameBytes = 256;         // Frames this long are decrypted in place, shorter ones gathered
+
     CryptoPP::SecByteBlock key_; // Encryption key, assigned at runtime
+    CryptoPP::SecByteBlock macKey_; // Authentication key, derived from key_
+    std::size_t batchWorkers_;   // Upper bound on threads per batch
+    std::unique_ptr<Executor> batchPool_; // Persistent helpers for large batches, null when batchWorkers is 1
 };
 
 #endif // AESCBCC_SECURITY_H
@@ -0,0 +1,26 @@
+// include/BlockingCall.h
+#ifndef BLOCKING_CALL_H
+#define BLOCKING_CALL_H
+
+#include <functional>
+#include <future>
+#include <utility>
+
+/**
+ * @brief Hands a job to another thread and blocks until it has produced its result.
+ *
+ * The caller blocks until the job has run, so the job may refer to the caller's arguments and locals.
+ *
+ * @param post Queues a std::function<void()> on the thread that runs the job, e.g. a lane or a reactor queue.
+ * @param job The job to run.
+ * @return The job's result.
+ */
+template <typename Post>
+bool blockingCall(Post&& post, const std::function<bool()>& job) {
+    std::promise<bool> result;
+    std::future<bool> done = result.get_future();
+    std::forward<Post>(post)([&job, &result]() { result.set_value(job()); });
+    return done.get();
+}
+
+#endif // BLOCKING_CALL_H
@@ -0,0 +1,62 @@
+// include/CommandScheduler.h
+#ifndef COMMAND_SCHEDULER_H
+#define COMMAND_SCHEDULER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Priority class of a command send.
+ */
+enum class CommandPriority {
+    Urgent, // Safety-relevant commands such as STOP; never wait behind bulk traffic
+    Bulk    // Configuration and other throughput traffic
+};
+
+/**
+ * @brief Two-lane job scheduler for command sends.
+ *
+ * Each lane is a FIFO queue. Bulk workers always take an urgent job before a bulk job, and one
+ * worker is reserved for the urgent lane, so an urgent job waits at most for the urgent jobs
+ * queued ahead of it, however many bulk jobs are queued or running. Jobs still queued when the
+ * scheduler is destroyed are run before the workers exit.
+ */
+class CommandScheduler {
+public:
+    /**
+     * @brief Starts the reserved urgent worker and the bulk workers.
+     *
+     * @param bulkWorkers Number of workers serving both lanes; at least one is always started.
+     */
+    explicit CommandScheduler(std::size_t bulkWorkers = 1);
+    ~CommandScheduler();
+
+    CommandScheduler(const CommandScheduler&) = delete;
+    CommandScheduler& operator=(const CommandScheduler&) = delete;
+
+    /**
+     * @brief Queues a job on a lane.
+     *
+     * @param priority The lane to queue the job on.
+     * @param job The job to run.
+     */
+    void submit(CommandPriority priority, std::function<void()> job);
+
+private:
+    void run(bool reserved);
+
+    std::mutex mtx_;
+    std::condition_variable urgentCv_; // Wakes the reserved urgent worker
+    std::condition_variable workCv_;   // Wakes the bulk workers
+    std::deque<std::function<void()>> urgent_;
+    std::deque<std::function<void()>> bulk_;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+#endif // COMMAND_SCHEDULER_H
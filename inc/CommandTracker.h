@@ -0,0 +1,145 @@
+// include/CommandTracker.h
+#ifndef COMMAND_TRACKER_H
+#define COMMAND_TRACKER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Delivery state of a tracked command.
+ */
+enum class CommandStatus {
+    Pending,      // Sent, not yet acknowledged
+    Acknowledged, // Marked in an acknowledgement from the device
+    Failed,       // Retransmitted too often, or passed by the device's replay window, without an acknowledgement
+    Unknown       // Never tracked, or forgotten
+};
+
+/**
+ * @brief Bookkeeping for sequence-numbered commands in flight to each device.
+ *
+ * Devices acknowledge selectively with their replay window: the highest command sequence number
+ * accepted and a 64-bit mask of the ones accepted before it, so a lost or failed command does not
+ * hold back the acknowledgement of later ones. A command's final status never changes once reported.
+ * The tracker performs no I/O; CommunicationInterface sends and retransmits the frames it reports.
+ */
+class CommandTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Completion {
+        std::string deviceId;
+        std::uint64_t sequence;
+        CommandStatus status;
+    };
+
+    struct Retransmission {
+        std::string deviceId;
+        std::string frame;
+    };
+
+    /**
+     * @param windowSize Maximum number of unacknowledged commands per device.
+     * @param ackTimeout Time to wait for an acknowledgement before retransmitting.
+     * @param maxRetransmits Retransmissions before a command is reported as failed.
+     */
+    CommandTracker(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits);
+
+    /**
+     * @brief Changes the window and retransmission policy; applies to commands sent afterwards.
+     *
+     * Commands already in flight keep the timeout and retransmission limit they were tracked with,
+     * and a smaller window only holds back new reservations.
+     */
+    void configure(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits);
+
+    /**
+     * @brief Reserves a slot in the device's window before a sequence number is allocated.
+     *
+     * @param deviceHandle The device's handle.
+     * @return true if the window has room, false if it is full.
+     */
+    bool reserve(std::uint64_t deviceHandle);
+
+    /**
+     * @brief Releases a reserved slot whose command was never sent.
+     *
+     * @param deviceHandle The device's handle.
+     */
+    void release(std::uint64_t deviceHandle);
+
+    /**
+     * @brief Turns a reserved slot into an in-flight command.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param deviceHandle The device's handle.
+     * @param sequence The command's sequence number.
+     * @param frame The sealed frame, kept for retransmission.
+     */
+    void track(const std::string& deviceId, std::uint64_t deviceHandle, std::uint64_t sequence, std::string frame);
+
+    /**
+     * @brief Applies a selective acknowledgement from a device.
+     *
+     * In-flight commands marked in the mask are acknowledged. Those 64 or more below the highest
+     * sequence number can no longer pass the device's replay window and are failed.
+     *
+     * @param deviceHandle The device's handle.
+     * @param acknowledged Highest sequence number the device has accepted.
+     * @param acknowledgedMask Bit i set when the device has accepted acknowledged - i.
+     * @return The commands completed by this acknowledgement.
+     */
+    std::vector<Completion> acknowledge(std::uint64_t deviceHandle, std::uint64_t acknowledged, std::uint64_t acknowledgedMask);
+
+    /**
+     * @brief Collects overdue commands: those with retransmissions left are returned for resending,
+     * the others are failed.
+     *
+     * @param failed Populated with the commands that ran out of retransmissions.
+     * @return The frames to retransmit.
+     */
+    std::vector<Retransmission> collectExpired(std::vector<Completion>& failed);
+
+    /**
+     * @brief Reports the delivery state of a command.
+     *
+     * @param deviceHandle The device's handle.
+     * @param sequence The command's sequence number.
+     * @return The command's status.
+     */
+    CommandStatus status(std::uint64_t deviceHandle, std::uint64_t sequence);
+
+private:
+    struct InFlight {
+        std::string frame;
+        Clock::time_point deadline;
+        int retransmits = 0;
+        std::chrono::milliseconds ackTimeout; // Policy when the command was tracked
+        int maxRetransmits;
+    };
+
+    struct DeviceWindow {
+        std::string deviceId;
+        std::size_t reserved = 0;                  // Slots reserved but not yet tracked
+        std::map<std::uint64_t, InFlight> inFlight; // Ordered by sequence number
+        std::map<std::uint64_t, CommandStatus> completed; // Final status of the most recent completed commands
+    };
+
+    void complete(DeviceWindow& device, std::uint64_t sequence, CommandStatus status, std::vector<Completion>& completions);
+
+    static constexpr std::size_t kCompletedHistory = 256;
+
+    std::mutex mtx_;
+    std::size_t windowSize_;
+    std::chrono::milliseconds ackTimeout_;
+    int maxRetransmits_;
+    std::unordered_map<std::uint64_t, DeviceWindow> devices_;
+};
+
+#endif // COMMAND_TRACKER_H
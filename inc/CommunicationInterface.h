@@ -6,10 +6,26 @@
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 
 // Include Local Header Files
 #include "ISecurity.h"
+#include "ITransport.h"
 #include "DataPacket.h" 
+#include "Executor.h"
+#include "FrameLog.h"
+#include "FrameHeader.h"
+#include "CommandTracker.h"
+#include "CommandScheduler.h"
+#include "Task.h"
 
 // For using the FRIEND_TEST macro
 #include <gtest/gtest_prod.h>
@@ -18,11 +34,12 @@
  *
  * This class provides methods to send control commands and receive states from other devices.
  * It handles data encoding/decoding, validation, and utilizes a security module for encryption and decryption.
+ * Without a transport, sending and receiving fall back to the platform-agnostic placeholders.
  */
 class CommunicationInterface {
 public:
     // Constructor and Destructor
-    CommunicationInterface(std::unique_ptr<ISecurity> securityModule);
+    CommunicationInterface(std::unique_ptr<ISecurity> securityModule, std::unique_ptr<ITransport> transport = nullptr);
     ~CommunicationInterface();
 
     // Public Methods
@@ -35,15 +52,158 @@ public:
      */
     bool sendControlCommand(const std::string& deviceId, const DataPacket::Command& command);
 
+    /*
+     * @brief Sends a control command on a priority lane and waits for the send to complete.
+     *
+     * Urgent commands are served by a worker reserved for them and skip the console echo, so they
+     * never queue behind bulk sends or the blocking path's mutex. Bulk commands are sent in order
+     * by the bulk worker.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param command The Command object to send.
+     * @param priority The lane to send the command on.
+     * @return true if sending is successful, false otherwise.
+     */
+    bool sendControlCommand(const std::string& deviceId, const DataPacket::Command& command, CommandPriority priority);
+
     /*
      * @brief Receives state data from a specified device, decrypts, decodes, and validates it.
      *
+     * With a transport attached, returns the oldest state already delivered for the device, if any.
+     *
      * @param deviceId The unique identifier of the source device.
      * @param state The State object to populate with received data.
      * @return true if receiving and processing is successful, false otherwise.
      */
     bool receiveState(const std::string& deviceId, DataPacket::State& state);
 
+    /*
+     * @brief Waits until a state from the device arrives or the timeout expires.
+     *
+     * The calling thread sleeps on a condition variable signalled as the transport delivers states,
+     * so no polling is needed. Without a transport this behaves like receiveState.
+     *
+     * @param deviceId The unique identifier of the source device.
+     * @param state The State object to populate with received data.
+     * @param timeout How long to wait for a state before giving up.
+     * @return true if a state was received in time, false otherwise.
+     */
+    bool receiveState(const std::string& deviceId, DataPacket::State& state, std::chrono::milliseconds timeout);
+
+    /*
+     * @brief Waits until a state from the device arrives or the deadline passes.
+     *
+     * @param deviceId The unique identifier of the source device.
+     * @param state The State object to populate with received data.
+     * @param deadline When to stop waiting.
+     * @return true if a state was received in time, false otherwise.
+     */
+    bool receiveState(const std::string& deviceId, DataPacket::State& state, std::chrono::steady_clock::time_point deadline);
+
+    /*
+     * @brief Waits until a state from any of the devices arrives or the timeout expires.
+     *
+     * If states are already pending for several devices, the first listed device's oldest state is returned.
+     *
+     * @param deviceIds The unique identifiers of the source devices.
+     * @param state The State object to populate with received data; state.deviceId tells which device it came from.
+     * @param timeout How long to wait for a state before giving up.
+     * @return true if a state was received in time, false otherwise.
+     */
+    bool waitAny(const std::vector<std::string>& deviceIds, DataPacket::State& state, std::chrono::milliseconds timeout);
+
+    /*
+     * @brief Waits until a state from any of the devices arrives or the deadline passes.
+     *
+     * @param deviceIds The unique identifiers of the source devices.
+     * @param state The State object to populate with received data; state.deviceId tells which device it came from.
+     * @param deadline When to stop waiting.
+     * @return true if a state was received in time, false otherwise.
+     */
+    bool waitAny(const std::vector<std::string>& deviceIds, DataPacket::State& state, std::chrono::steady_clock::time_point deadline);
+
+    /*
+     * @brief Sends a sequence-numbered command and tracks it until the device acknowledges it.
+     *
+     * Up to the window size of commands may be in flight per device, so commands can be pipelined
+     * over a high-latency link. Acknowledgements arrive in the header of incoming State frames.
+     * A command whose first transmission fails stays tracked and is resent by retransmitExpired.
+     * Retransmission is driven by the caller: no timer is armed, so overdue commands are only resent
+     * or failed when retransmitExpired is called.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param command The Command object to send.
+     * @return The command's sequence number, or 0 if it is invalid or the device's window is full.
+     */
+    std::uint64_t sendTrackedCommand(const std::string& deviceId, const DataPacket::Command& command);
+
+    /*
+     * @brief Reports the delivery state of a tracked command.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param sequence The sequence number returned by sendTrackedCommand.
+     * @return The command's status.
+     */
+    CommandStatus commandStatus(const std::string& deviceId, std::uint64_t sequence);
+
+    /*
+     * @brief Resends tracked commands whose acknowledgement is overdue.
+     *
+     * Commands that exhausted their retransmissions are reported as failed. Call periodically,
+     * e.g. from a task rescheduled with Executor::postAfter.
+     *
+     * @return The number of frames retransmitted.
+     */
+    std::size_t retransmitExpired();
+
+    /*
+     * @brief Sets the per-device window and retransmission policy of tracked commands.
+     *
+     * Applies to commands sent afterwards; commands in flight keep the policy they were sent with.
+     *
+     * @param windowSize Maximum number of unacknowledged commands per device.
+     * @param ackTimeout Time to wait for an acknowledgement before retransmitting.
+     * @param maxRetransmits Retransmissions before a command is reported as failed.
+     */
+    void setCommandWindow(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits);
+
+    /*
+     * @brief Sets a callback invoked when a tracked command is acknowledged or fails.
+     *
+     * @param callback A function taking the device ID, the sequence number and the final status.
+     */
+    void setCommandCallback(std::function<void(const std::string&, std::uint64_t, CommandStatus)> callback);
+
+    /*
+     * @brief Awaitable version of sendControlCommand.
+     *
+     * Moves the awaiting coroutine onto the executor before validating, encoding and encrypting,
+     * so the caller never runs the cipher on its own thread.
+     *
+     * @param executor The executor the coroutine is resumed on.
+     * @param deviceId The unique identifier of the target device.
+     * @param command The Command object to send.
+     * @return true if sending is successful, false otherwise.
+     */
+    Task<bool> sendControlCommandAsync(Executor& executor, std::string deviceId, DataPacket::Command command);
+
+    /*
+     * @brief Awaitable version of receiveState.
+     *
+     * Suspends until the transport delivers a state for the device or the timeout expires,
+     * then resumes on the executor. Requires a transport; without one it behaves like receiveState.
+     * The CommunicationInterface must outlive every pending receive; timeouts still queued on the
+     * executor after it is destroyed do nothing.
+     *
+     * @param executor The executor the coroutine is resumed on.
+     * @param deviceId The unique identifier of the source device.
+     * @param state The State object to populate with received data.
+     * @param timeout How long to wait for a state before giving up.
+     * @return true if a state was received in time, false otherwise.
+     */
+    Task<bool> receiveStateAsync(Executor& executor, std::string deviceId, DataPacket::State& state,
+                                 std::chrono::milliseconds timeout);
+
     /*
      * @brief Sets a callback function to handle received states.
      *
@@ -51,6 +211,56 @@ public:
      */
     void setStateCallback(std::function<void(const DataPacket::State&)> callback);
 
+    /*
+     * @brief Starts appending every sent and received frame to a memory-mapped capture log.
+     *
+     * Replaces any capture already in progress. The log can be streamed back with ReplayTransport.
+     *
+     * @param path Path of the log file; an existing file is truncated.
+     * @return true if capturing started, false if the log could not be created.
+     */
+    bool startCapture(const std::string& path);
+
+    /*
+     * @brief Stops capturing and closes the capture log.
+     */
+    void stopCapture();
+
+    /*
+     * @brief Restricts which devices this interface accepts frames from.
+     *
+     * Frames are matched on the device handle in their header (FrameHeader::deviceHandle) before any
+     * cryptography runs. Frames from other devices are handed to reroute, or dropped if it is empty.
+     *
+     * @param owns Returns true for device handles this interface accepts; empty accepts every device.
+     * @param reroute Receives frames from other devices, e.g. to forward them to the interface owning them.
+     */
+    void setDeviceScope(std::function<bool(std::uint64_t)> owns, std::function<void(std::string_view)> reroute = nullptr);
+
+    /*
+     * @brief Processes frames that arrived outside the attached transport, e.g. rerouted by another interface.
+     *
+     * The frames go through the same header checks, batch decryption and routing as transport frames.
+     *
+     * @param frames The complete frames, valid for the duration of the call.
+     */
+    void ingestFrames(const std::vector<std::string_view>& frames);
+
+    /*
+     * @brief Drains every readable frame from the transport and hands them to ingestFrames.
+     *
+     * The interface calls it from the transport's readable callback. An owner that replaces that
+     * callback, e.g. to process frames on its own thread, calls it there instead.
+     */
+    void drainTransport();
+
+    /*
+     * @brief Enables or disables the console echo of encoded commands.
+     *
+     * @param enabled false to stop writing every encoded command to std::cout.
+     */
+    void setCommandEcho(bool enabled);
+
 private:
     // Data Manipulation Methods
     /*
@@ -77,9 +287,10 @@ private:
      *
      * @param deviceId The unique identifier of the target device.
      * @param data The encrypted data to send.
+     * @param priority The frame's lane; urgent frames are not echoed to the console.
      * @return true if sending is successful, false otherwise.
      */
-    bool sendData(const std::string& deviceId, const std::string& data);
+    bool sendData(const std::string& deviceId, const std::string& data, CommandPriority priority = CommandPriority::Bulk);
 
     /*
      * @brief Placeholder method to simulate receiving data.
@@ -89,16 +300,195 @@ private:
      */
     bool receiveData(std::string& data);
 
+    // Frame Processing Methods
+    /*
+     * @brief Validates, encodes and encrypts a command into a frame ready for sendData.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param command The Command object to prepare.
+     * @param frame Populated with the encrypted frame.
+     * @param sequence If not null, populated with the frame's sequence number.
+     * @param priority The command's lane; urgent commands are not echoed to the console.
+     * @return true if the frame was produced, false otherwise.
+     */
+    bool prepareCommand(const std::string& deviceId, const DataPacket::Command& command, std::string& frame,
+                        std::uint64_t* sequence = nullptr, CommandPriority priority = CommandPriority::Bulk);
+
+    /*
+     * @brief Checks that a frame is a State frame, then its sequence number against the replay window, then its tag.
+     *
+     * Records the sequence number only once the frame is authentic. Runs no AES and no JSON.
+     *
+     * @param frame The complete frame.
+     * @param header The header fields already read from the frame.
+     * @return true if the frame is fresh and authentic, false otherwise.
+     */
+    bool admitFrame(std::string_view frame, const FrameHeader::Header& header);
+
+    /*
+     * @brief Completes tracked commands marked in the selective acknowledgement of an admitted State frame.
+     *
+     * @param header The header fields of the admitted frame.
+     * @param completions Appended with the completed commands, for the caller to report once it holds no lock.
+     */
+    void applyAcknowledgement(const FrameHeader::Header& header, std::vector<CommandTracker::Completion>& completions);
+
+    /*
+     * @brief Invokes the command callback, if set, for each completed command.
+     *
+     * Must be called with no lock held, so the callback may send or receive through this interface.
+     *
+     * @param completions The acknowledged or failed commands.
+     */
+    void reportCompletions(const std::vector<CommandTracker::Completion>& completions);
+
+    /*
+     * @brief Returns the next outgoing sequence number for a device.
+     *
+     * @param deviceHandle The handle of the target device.
+     * @return The sequence number, starting at 1.
+     */
+    std::uint64_t nextSequence(std::uint64_t deviceHandle);
+
+    /*
+     * @brief Decrypts and decodes an admitted frame into a State object.
+     *
+     * @param frame The complete frame, already admitted by admitFrame.
+     * @param state The State object to populate.
+     * @return true if the frame holds a valid state, false otherwise.
+     */
+    bool processFrame(std::string_view frame, DataPacket::State& state);
+
+    /*
+     * @brief Decodes an already decrypted frame into a State object.
+     *
+     * @param decrypted The decrypted frame; empty if decryption failed.
+     * @param state The State object to populate.
+     * @return true if the frame holds a valid state, false otherwise.
+     */
+    bool decodeFrame(const std::string& decrypted, DataPacket::State& state);
+
+    /*
+     * @brief Appends a frame to the capture log if capturing is active.
+     *
+     * @param direction Whether the frame was sent or received.
+     * @param deviceId The device the frame belongs to, empty if unknown.
+     * @param frame The encrypted frame.
+     */
+    void captureFrame(FrameDirection direction, std::string_view deviceId, std::string_view frame);
+
+    /*
+     * @brief Takes the next state for a device from its mailbox, or receives and processes a placeholder frame.
+     *
+     * Called with mtx_ held; the caller reports the completions and invokes the state callback after releasing it.
+     *
+     * @param deviceId The unique identifier of the source device.
+     * @param state The State object to populate with received data.
+     * @param completions Populated with the tracked commands acknowledged by a placeholder frame.
+     * @return true if a state for the device was taken, false otherwise.
+     */
+    bool takeState(const std::string& deviceId, DataPacket::State& state, std::vector<CommandTracker::Completion>& completions);
+
+    /*
+     * @brief Invokes the state callback, if set, for a state handed to a caller.
+     *
+     * @param state The received state.
+     */
+    void notifyState(const DataPacket::State& state);
+
+    // Asynchronous Delivery
+    struct PendingReceive {
+        std::coroutine_handle<> handle;
+        Executor* executor = nullptr;
+        Executor::TimerId timer = 0; // Timeout armed in await_suspend, cancelled on delivery
+        DataPacket::State state;
+        bool success = false;
+    };
+
+    // Shared with executor timers so they can tell whether the interface still exists
+    struct Lifetime {
+        std::mutex mtx; // Held while a timer uses the interface
+        bool alive = true;
+    };
+
+    struct ReceiveAwaiter {
+        CommunicationInterface& comm;
+        const std::string& deviceId;
+        const std::shared_ptr<PendingReceive>& pending;
+        std::chrono::milliseconds timeout;
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    /*
+     * @brief Hands a state to the oldest pending receive for its device, or queues it in the mailbox and wakes blocked receivers.
+     *
+     * @param state The decoded state.
+     */
+    void deliverState(DataPacket::State state);
+
+    /*
+     * @brief Fails a pending receive whose timeout expired before a state arrived.
+     *
+     * @param deviceId The device the receive is waiting on.
+     * @param pending The pending receive.
+     */
+    void expireReceive(const std::string& deviceId, const std::shared_ptr<PendingReceive>& pending);
+
+    static constexpr std::size_t kMaxMailboxDepth = 64; // Oldest states are dropped beyond this
+
     // Member Variables
     std::mutex mtx_; // For thread safety
     std::function<void(const DataPacket::State&)> stateCallback_;
     std::unique_ptr<ISecurity> securityModule_; // Security module
+    std::unique_ptr<ITransport> transport_; // Optional transport, placeholders are used when null
+
+    std::mutex inboxMutex_; // Guards waiters_, mailboxes_ and blockedReceivers_
+    std::unordered_map<std::string, std::deque<std::shared_ptr<PendingReceive>>> waiters_;
+    std::unordered_map<std::string, std::deque<DataPacket::State>> mailboxes_;
+    std::condition_variable stateArrived_; // Signalled when a state enters a mailbox while receivers are blocked
+    std::size_t blockedReceivers_ = 0; // Threads sleeping in the blocking receiveState or waitAny
+    std::shared_ptr<Lifetime> lifetime_ = std::make_shared<Lifetime>(); // Cleared before destruction
+
+    std::mutex captureMutex_; // Guards capture_
+    std::shared_ptr<FrameLogWriter> capture_; // Active capture log, null when not capturing
+
+    struct DeviceScope {
+        std::function<bool(std::uint64_t)> owns;
+        std::function<void(std::string_view)> reroute;
+    };
+    std::mutex scopeMutex_; // Guards deviceScope_
+    std::shared_ptr<const DeviceScope> deviceScope_; // Null when every device is accepted
+
+    const std::uint64_t sessionEpoch_ = FrameHeader::newEpoch(); // Epoch of every frame this instance seals
+    std::mutex sequenceMutex_; // Guards txSequences_ and rxWindows_
+    std::unordered_map<std::uint64_t, std::uint64_t> txSequences_; // Last sequence number sent per device handle
+    std::unordered_map<std::uint64_t, FrameHeader::ReplayWindow> rxWindows_; // Accepted sequence numbers per device handle
+    std::atomic<std::uint64_t> syntheticSequence_{0}; // Sequence numbers of the placeholder receiveData frames
+
+    static constexpr std::size_t kDefaultCommandWindow = 32;
+    static constexpr std::chrono::milliseconds kDefaultAckTimeout{200};
+    static constexpr int kDefaultMaxRetransmits = 3;
+
+    CommandTracker commandTracker_; // In-flight tracked commands per device
+    std::mutex commandCallbackMutex_; // Guards commandCallback_
+    std::function<void(const std::string&, std::uint64_t, CommandStatus)> commandCallback_;
+
+    std::atomic<bool> commandEcho_{true}; // Echo encoded commands to std::cout
+
+    static constexpr std::size_t kBulkWorkers = 1;
+
+    std::once_flag schedulerOnce_; // Workers start on the first prioritized send
+    std::unique_ptr<CommandScheduler> scheduler_; // Declared last: its workers are joined before other members go away
 
     // Grant access to specific test cases
     FRIEND_TEST(CommunicationInterfaceTest, RQ003_EncodeCommand_Success);
     FRIEND_TEST(CommunicationInterfaceTest, RQ004_DecodeState_Success);
     FRIEND_TEST(CommunicationInterfaceTest, RQ004_DecodeState_MissingDeviceId);
     FRIEND_TEST(CommunicationInterfaceTest, RQ005_EncryptDecrypt_Success);
+    FRIEND_TEST(CommunicationInterfaceTest, RQ009_AsyncConversations_Loopback_Success);
 };
 
 #endif // COMMUNICATION_INTERFACE_H
\ No newline at end of file
@@ -28,10 +28,6 @@ struct Command {
         if(duration <= 0) {
             throw std::invalid_argument("Duration must be positive.");
         }
-        else
-        {
-            std::cout << "Command validated successfully.\n";
-        }
     }
 };
 
@@ -0,0 +1,105 @@
+// include/Executor.h
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Fixed-size thread pool on which coroutines are resumed.
+ *
+ * Runs posted tasks in FIFO order and delayed tasks once their deadline
+ * expires. Tasks still queued when the executor is destroyed are discarded.
+ */
+class Executor {
+public:
+    using Clock = std::chrono::steady_clock;
+    using TimerId = std::uint64_t;
+
+    /**
+     * @brief Starts the worker threads.
+     *
+     * @param threadCount Number of workers; at least one is always started.
+     */
+    explicit Executor(std::size_t threadCount = std::thread::hardware_concurrency());
+    ~Executor();
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /**
+     * @brief Queues a task to run on one of the workers.
+     *
+     * @param task The task to run.
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * @brief Queues a task to run once the given delay has elapsed.
+     *
+     * @param delay Minimum time to wait before running the task.
+     * @param task The task to run.
+     * @return A handle for cancel().
+     */
+    TimerId postAfter(Clock::duration delay, std::function<void()> task);
+
+    /**
+     * @brief Discards a delayed task that has not been started yet.
+     *
+     * @param timer The handle returned by postAfter.
+     * @return true if the task was discarded, false if it already ran, is running or was cancelled.
+     */
+    bool cancel(TimerId timer);
+
+    /**
+     * @brief Returns the number of delayed tasks whose deadline has not expired yet.
+     */
+    std::size_t pendingTimers();
+
+    /**
+     * @brief Resumes a suspended coroutine on one of the workers.
+     *
+     * @param handle The coroutine to resume.
+     */
+    void resume(std::coroutine_handle<> handle) {
+        post([handle]() { handle.resume(); });
+    }
+
+    /**
+     * @brief Awaitable that moves the awaiting coroutine onto the executor.
+     */
+    auto schedule() {
+        struct ScheduleAwaiter {
+            Executor& executor;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { executor.resume(handle); }
+            void await_resume() const noexcept {}
+        };
+        return ScheduleAwaiter{*this};
+    }
+
+private:
+    void run();
+
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<std::function<void()>> tasks_;
+    using TimerQueue = std::multimap<Clock::time_point, std::pair<TimerId, std::function<void()>>>;
+    TimerQueue timers_;
+    std::unordered_map<TimerId, TimerQueue::iterator> timerIndex_; // Pending timers by handle, for cancel()
+    TimerId nextTimer_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+};
+
+#endif // EXECUTOR_H
@@ -0,0 +1,182 @@
+// include/FrameHeader.h
+#ifndef FRAME_HEADER_H
+#define FRAME_HEADER_H
+
+#include "ISecurity.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Authenticated header carried in front of every encrypted frame.
+ *
+ * Wire layout (little endian):
+ *   [0, 16)  tag:       truncated MAC over every byte after the tag (header fields and payload)
+ *   [16]     version
+ *   [17]     frame type (direction): 1 for Command frames (host to device), 2 for State frames
+ *            (device to host)
+ *   [18, 26) session epoch, chosen by the sender when it starts and increasing across its restarts
+ *   [26, 34) device handle, a 64-bit hash of the device ID
+ *   [34, 42) sequence number, starting at 1 per device, direction and session epoch
+ *   [42, 50) acknowledgement: in State frames, the highest command sequence number the device
+ *            has accepted; 0 in Command frames
+ *   [50, 58) acknowledgement mask: bit i set when the device has accepted command
+ *            acknowledgement - i (the receiver's ReplayWindow, see highest() and seen())
+ *   [58, ..) encrypted payload
+ *
+ * The device handle, frame type, epoch and sequence number can be read without any cryptography, so
+ * frames for other devices and replays are rejected before the MAC, AES or JSON are touched. Host and
+ * devices share the MAC key, so the authenticated frame type is what stops a Command frame reflected
+ * back to its sender from being taken for a State frame.
+ */
+namespace FrameHeader {
+
+constexpr std::uint8_t kVersion = 5;
+constexpr std::size_t kTagSize = ISecurity::kTagSize;
+constexpr std::size_t kSize = kTagSize + 1 + 1 + 8 + 8 + 8 + 8 + 8;
+
+enum class FrameType : std::uint8_t {
+    Command = 1, // Host to device
+    State = 2    // Device to host
+};
+
+struct Header {
+    FrameType type;
+    std::uint64_t deviceHandle;
+    std::uint64_t sequence;
+    std::uint64_t acknowledged = 0;
+    std::uint64_t acknowledgedMask = 0;
+    std::uint64_t epoch = 0;
+};
+
+/**
+ * @brief Returns a session epoch for a sender starting now.
+ *
+ * The epoch is the wall-clock time in nanoseconds, so a restarted sender, whose sequence numbers
+ * start again at 1, is told apart from its previous session as long as its clock does not step
+ * back across the restart.
+ *
+ * @return A non-zero session epoch.
+ */
+std::uint64_t newEpoch();
+
+/**
+ * @brief Maps a device ID to its compact handle (64-bit FNV-1a).
+ *
+ * @param deviceId The unique identifier of the device.
+ * @return The device handle.
+ */
+std::uint64_t deviceHandle(std::string_view deviceId);
+
+/**
+ * @brief Prepends an authenticated header to an encrypted payload.
+ *
+ * @param security The security module producing the tag.
+ * @param header The header fields.
+ * @param payload The encrypted payload.
+ * @return The complete frame, or empty if the tag could not be computed.
+ */
+std::string seal(ISecurity& security, const Header& header, std::string_view payload);
+
+/**
+ * @brief Reads the header fields without verifying the tag.
+ *
+ * @param frame The complete frame.
+ * @param header Populated with the header fields.
+ * @return true if the frame is long enough and has a known version and frame type, false otherwise.
+ */
+bool parse(std::string_view frame, Header& header);
+
+/**
+ * @brief Verifies the tag over the header fields and payload.
+ *
+ * @param security The security module checking the tag.
+ * @param frame The complete frame.
+ * @return true if the frame is authentic, false otherwise.
+ */
+bool verify(ISecurity& security, std::string_view frame);
+
+/**
+ * @brief Returns the encrypted payload following the header.
+ *
+ * @param frame A frame accepted by parse().
+ * @return A view of the payload.
+ */
+inline std::string_view payload(std::string_view frame) {
+    return frame.substr(kSize);
+}
+
+/**
+ * @brief Sliding window of recently accepted sequence numbers for one device.
+ *
+ * Accepts each sequence number at most once and tolerates reordering within the last 64 frames.
+ * A frame from a newer session epoch starts the window afresh, so a rebooted device is accepted
+ * from sequence number 1; frames from older epochs are rejected from then on. The window lives in
+ * memory only: a restarted receiver accepts the first authentic epoch it sees for each device.
+ */
+class ReplayWindow {
+public:
+    /**
+     * @brief Checks whether a sequence number would be accepted, without recording it.
+     *
+     * @param epoch The sender's session epoch.
+     * @param sequence The sequence number to check.
+     * @return true if the sequence number is new and inside the window, false otherwise.
+     */
+    bool check(std::uint64_t epoch, std::uint64_t sequence) const {
+        if (sequence == 0 || epoch < epoch_) {
+            return false;
+        }
+        if (epoch > epoch_ || sequence > highest_) {
+            return true;
+        }
+        std::uint64_t age = highest_ - sequence;
+        return age < 64 && (seen_ & (std::uint64_t(1) << age)) == 0;
+    }
+
+    /**
+     * @brief Records a sequence number accepted by check() after its frame was authenticated.
+     *
+     * @param epoch The sender's session epoch.
+     * @param sequence The sequence number to record.
+     */
+    void update(std::uint64_t epoch, std::uint64_t sequence) {
+        if (epoch > epoch_) {
+            epoch_ = epoch;
+            highest_ = 0;
+            seen_ = 0;
+        }
+        if (sequence > highest_) {
+            std::uint64_t shift = sequence - highest_;
+            seen_ = shift < 64 ? (seen_ << shift) : 0;
+            seen_ |= 1;
+            highest_ = sequence;
+        } else {
+            seen_ |= std::uint64_t(1) << (highest_ - sequence);
+        }
+    }
+
+    /**
+     * @brief Returns the highest sequence number accepted in the current epoch, 0 if none.
+     */
+    std::uint64_t highest() const {
+        return highest_;
+    }
+
+    /**
+     * @brief Returns the accepted sequence numbers as a mask: bit i is set when highest() - i was accepted.
+     */
+    std::uint64_t seen() const {
+        return seen_;
+    }
+
+private:
+    std::uint64_t epoch_ = 0;   // Session epoch the window belongs to
+    std::uint64_t highest_ = 0; // Highest sequence number accepted so far
+    std::uint64_t seen_ = 0;    // Bit i set when highest_ - i was accepted
+};
+
+} // namespace FrameHeader
+
+#endif // FRAME_HEADER_H
@@ -0,0 +1,124 @@
+// include/FrameLog.h
+#ifndef FRAME_LOG_H
+#define FRAME_LOG_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Direction of a captured frame relative to this interface.
+ */
+enum class FrameDirection : std::uint8_t {
+    Sent = 0,
+    Received = 1
+};
+
+/**
+ * @brief One captured frame, viewed in place inside the memory-mapped log.
+ */
+struct FrameRecord {
+    std::uint64_t timestampNs;  // Monotonic capture time in nanoseconds since the log was created
+    std::uint64_t wallClockNs;  // Wall-clock capture time in nanoseconds since the epoch; may step
+    FrameDirection direction;
+    std::string_view deviceId;  // Empty when the device could not be determined
+    std::string_view frame;     // Encrypted frame bytes exactly as sent or received
+};
+
+/**
+ * @brief Append-only, memory-mapped log of encrypted frames.
+ *
+ * Layout: a 16-byte file header (magic, version, committed data size) followed by
+ * records of a 24-byte record header, the device ID and the frame, padded to 8 bytes.
+ * Records carry a monotonic timestamp, used for ordering and replay pacing, and the
+ * wall-clock time for display.
+ * The committed size is updated after each record is written, so a log cut short by
+ * a crash is still readable up to its last complete record.
+ */
+class FrameLogWriter {
+public:
+    /**
+     * @brief Creates (or truncates) the log file and maps it.
+     *
+     * @param path Path of the log file.
+     * @throws std::runtime_error if the file cannot be created or mapped.
+     */
+    explicit FrameLogWriter(const std::string& path);
+    ~FrameLogWriter();
+
+    FrameLogWriter(const FrameLogWriter&) = delete;
+    FrameLogWriter& operator=(const FrameLogWriter&) = delete;
+
+    /**
+     * @brief Appends a frame stamped with the current monotonic and wall-clock time.
+     *
+     * @param direction Whether the frame was sent or received.
+     * @param deviceId The device the frame belongs to, empty if unknown.
+     * @param frame The encrypted frame.
+     * @return true if the record was written, false if the log could not grow.
+     */
+    bool append(FrameDirection direction, std::string_view deviceId, std::string_view frame);
+
+private:
+    bool reserve(std::size_t bytes);
+
+    std::mutex mtx_; // Serializes appends from the send and receive paths
+    std::chrono::steady_clock::time_point created_; // Origin of the monotonic timestamps
+    int fd_ = -1;
+    unsigned char* base_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+};
+
+/**
+ * @brief Read-only view of a frame log with a per-device index.
+ *
+ * Records point straight into the mapping and stay valid for the reader's lifetime.
+ */
+class FrameLogReader {
+public:
+    /**
+     * @brief Maps the log and indexes its records.
+     *
+     * @param path Path of the log file.
+     * @throws std::runtime_error if the file cannot be opened or is not a frame log.
+     */
+    explicit FrameLogReader(const std::string& path);
+    ~FrameLogReader();
+
+    FrameLogReader(const FrameLogReader&) = delete;
+    FrameLogReader& operator=(const FrameLogReader&) = delete;
+
+    std::size_t size() const { return records_.size(); }
+
+    const FrameRecord& record(std::size_t index) const { return records_[index]; }
+
+    /**
+     * @brief Returns the indices of every record for the given device, in capture order.
+     *
+     * @param deviceId The device to look up.
+     * @return Record indices, empty if the device never appears.
+     */
+    const std::vector<std::size_t>& recordsForDevice(std::string_view deviceId) const;
+
+    /**
+     * @brief Returns the index of the first record captured at or after the given time.
+     *
+     * @param timestampNs Monotonic time in nanoseconds since the log was created (FrameRecord::timestampNs).
+     * @return The record index, or size() if every record is older.
+     */
+    std::size_t lowerBound(std::uint64_t timestampNs) const;
+
+private:
+    const unsigned char* base_ = nullptr;
+    std::size_t mappedSize_ = 0;
+    std::vector<FrameRecord> records_;
+    std::unordered_map<std::string_view, std::vector<std::size_t>> deviceIndex_;
+};
+
+#endif // FRAME_LOG_H
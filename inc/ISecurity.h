@@ -3,11 +3,14 @@
 #define ISECURITY_H
 
 #include <string>
+#include <string_view>
+#include <cstddef>
+#include <vector>
 
 /**
  * @brief Interface for security operations.
  *
- * Defines the contract for encryption and decryption strategies.
+ * Defines the contract for encryption, decryption and message authentication strategies.
  */
 class ISecurity {
 public:
@@ -24,10 +27,49 @@ public:
     /**
      * @brief Decrypts the given ciphertext.
      *
+     * Takes a view so frames can be decrypted in place, e.g. straight from a memory-mapped capture.
+     *
      * @param cipherText The data to decrypt.
      * @return The decrypted data.
      */
-    virtual std::string decrypt(const std::string& cipherText) = 0;
+    virtual std::string decrypt(std::string_view cipherText) = 0;
+
+    /**
+     * @brief Decrypts many ciphertexts in one call.
+     *
+     * Implementations may interleave the frames to keep the cipher pipeline full.
+     * The default decrypts them one by one.
+     *
+     * @param cipherTexts The data to decrypt.
+     * @return The decrypted data, in input order; an entry is empty if its frame failed to decrypt.
+     */
+    virtual std::vector<std::string> decryptBatch(const std::vector<std::string_view>& cipherTexts) {
+        std::vector<std::string> plainTexts;
+        plainTexts.reserve(cipherTexts.size());
+        for (std::string_view cipherText : cipherTexts) {
+            plainTexts.push_back(decrypt(cipherText));
+        }
+        return plainTexts;
+    }
+
+    /**
+     * @brief Computes an authentication tag over the given message.
+     *
+     * @param message The data to authenticate.
+     * @return The tag, kTagSize bytes long, or empty on failure.
+     */
+    virtual std::string authenticate(std::string_view message) = 0;
+
+    /**
+     * @brief Checks an authentication tag in constant time.
+     *
+     * @param message The authenticated data.
+     * @param tag The tag to check.
+     * @return true if the tag matches the message, false otherwise.
+     */
+    virtual bool verify(std::string_view message, std::string_view tag) = 0;
+
+    static constexpr std::size_t kTagSize = 16; // Length of tags produced by authenticate()
 };
 
 #endif // ISECURITY_H
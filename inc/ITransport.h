@@ -0,0 +1,74 @@
+// include/ITransport.h
+#ifndef ITRANSPORT_H
+#define ITRANSPORT_H
+
+#include <string>
+#include <string_view>
+#include <functional>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Interface for the underlying frame transport.
+ *
+ * Defines the contract between CommunicationInterface and the networking
+ * platform. Frames are opaque, already encrypted byte strings.
+ */
+class ITransport {
+public:
+    virtual ~ITransport() {}
+
+    /**
+     * @brief Sends a frame to the given device.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param frame The encrypted frame to send.
+     * @return true if the frame was handed to the transport, false otherwise.
+     */
+    virtual bool send(const std::string& deviceId, const std::string& frame) = 0;
+
+    /**
+     * @brief Takes the next pending frame without blocking.
+     *
+     * @param frame Populated with the received frame.
+     * @return true if a frame was available, false if nothing is pending.
+     */
+    virtual bool receive(std::string& frame) = 0;
+
+    /**
+     * @brief Hands every pending frame to the handler as one batch without blocking.
+     *
+     * The views are valid only for the duration of the handler call. Transports that own
+     * their frame memory override this to avoid copying; the default copies via receive().
+     *
+     * @param handler Invoked once with all pending frames; not invoked if nothing is pending.
+     * @return The number of frames handled.
+     */
+    virtual std::size_t drain(const std::function<void(const std::vector<std::string_view>&)>& handler) {
+        std::vector<std::string> frames;
+        std::string frame;
+        while (receive(frame)) {
+            frames.push_back(std::move(frame));
+        }
+        if (frames.empty()) {
+            return 0;
+        }
+        std::vector<std::string_view> views(frames.begin(), frames.end());
+        handler(views);
+        return views.size();
+    }
+
+    /**
+     * @brief Registers a callback invoked whenever frames become readable.
+     *
+     * The callback may be invoked from any thread, including from inside a
+     * send() call on the peer side. Passing an empty function unregisters it.
+     * Replacing the callback is synchronous: on return, the previous callback is no
+     * longer running on any other thread, so the state it captures may be destroyed.
+     *
+     * @param callback The readiness callback.
+     */
+    virtual void setReadableCallback(std::function<void()> callback) = 0;
+};
+
+#endif // ITRANSPORT_H
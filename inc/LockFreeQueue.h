@@ -0,0 +1,108 @@
+// include/LockFreeQueue.h
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief Bounded multi-producer, multi-consumer FIFO queue without locks.
+ *
+ * Each cell carries a sequence number that tells producers and consumers whether it is free or
+ * full for their lap around the ring (D. Vyukov's bounded queue), so a push or pop is one
+ * compare-and-swap on the shared index plus one store to the cell.
+ *
+ * @tparam T Element type; must be default constructible and movable.
+ */
+template <typename T>
+class LockFreeQueue {
+public:
+    /**
+     * @param capacity Maximum number of queued elements; must be a power of two.
+     */
+    explicit LockFreeQueue(std::size_t capacity)
+        : mask_(capacity - 1), cells_(new Cell[capacity]) {
+        if (capacity < 2 || (capacity & mask_) != 0) {
+            throw std::invalid_argument("Queue capacity must be a power of two.");
+        }
+        for (std::size_t i = 0; i < capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LockFreeQueue(const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+    /**
+     * @brief Appends an element unless the queue is full.
+     *
+     * @param value The element; left untouched if the queue is full.
+     * @return true if the element was queued, false if the queue is full.
+     */
+    bool tryPush(T& value) {
+        std::size_t position = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lap = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (lap == 0) {
+                if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lap < 0) {
+                return false;
+            } else {
+                position = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest element unless the queue is empty.
+     *
+     * @param value Populated with the element.
+     * @return true if an element was removed, false if the queue is empty.
+     */
+    bool tryPop(T& value) {
+        std::size_t position = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells_[position & mask_];
+            std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto lap = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (lap == 0) {
+                if (head_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.value = T();
+                    cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lap < 0) {
+                return false;
+            } else {
+                position = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    // Producers and consumers update different indices; keep them on separate cache lines
+    static constexpr std::size_t kCacheLine = 64;
+
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(kCacheLine) std::atomic<std::size_t> tail_{0};
+    alignas(kCacheLine) std::atomic<std::size_t> head_{0};
+};
+
+#endif // LOCK_FREE_QUEUE_H
@@ -0,0 +1,48 @@
+// include/LoopbackTransport.h
+#ifndef LOOPBACK_TRANSPORT_H
+#define LOOPBACK_TRANSPORT_H
+
+#include "ITransport.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+/**
+ * @brief In-process transport connecting two endpoints back to back.
+ *
+ * Frames sent on one endpoint become readable on the other. Useful for
+ * simulating a peer device in tests and demos.
+ */
+class LoopbackTransport : public ITransport {
+public:
+    /**
+     * @brief Creates two connected endpoints.
+     *
+     * @return The pair of endpoints; frames sent on either arrive on the other.
+     */
+    static std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> createPair();
+
+    bool send(const std::string& deviceId, const std::string& frame) override;
+
+    bool receive(std::string& frame) override;
+
+    void setReadableCallback(std::function<void()> callback) override;
+
+private:
+    struct Channel {
+        std::mutex mtx;
+        std::condition_variable idle; // Signalled when a callback invocation returns
+        std::deque<std::string> frames;
+        std::function<void()> readableCallback;
+        std::size_t runningCallbacks = 0; // Invocations of readableCallback in progress
+    };
+
+    LoopbackTransport(std::shared_ptr<Channel> inbound, std::shared_ptr<Channel> outbound);
+
+    std::shared_ptr<Channel> inbound_;  // Frames addressed to this endpoint
+    std::shared_ptr<Channel> outbound_; // Frames addressed to the peer endpoint
+};
+
+#endif // LOOPBACK_TRANSPORT_H
@@ -0,0 +1,81 @@
+// include/ReplayTransport.h
+#ifndef REPLAY_TRANSPORT_H
+#define REPLAY_TRANSPORT_H
+
+#include "ITransport.h"
+#include "FrameLog.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Pacing used when streaming a frame log back.
+ */
+enum class ReplaySpeed {
+    Original, // Preserve the captured gaps between frames
+    Maximum   // Release every frame at once
+};
+
+/**
+ * @brief Transport that streams the received frames of a capture log back into a CommunicationInterface.
+ *
+ * Frames are handed out as views into the log's memory mapping, so the drain path copies nothing.
+ * Frames sent while replaying are discarded.
+ */
+class ReplayTransport : public ITransport {
+public:
+    /**
+     * @brief Opens the capture log.
+     *
+     * @param path Path of a log written by FrameLogWriter.
+     * @param speed Pacing of the replay.
+     * @throws std::runtime_error if the log cannot be opened.
+     */
+    ReplayTransport(const std::string& path, ReplaySpeed speed);
+    ~ReplayTransport();
+
+    /**
+     * @brief Starts releasing frames on a pacing thread. Has no effect if already started.
+     */
+    void start();
+
+    /**
+     * @brief Blocks until every captured frame has been released and handed to the readable callback.
+     */
+    void waitUntilFinished();
+
+    /**
+     * @brief Returns the number of received frames in the log.
+     */
+    std::size_t frameCount() const { return frames_.size(); }
+
+    bool send(const std::string& deviceId, const std::string& frame) override;
+
+    bool receive(std::string& frame) override;
+
+    std::size_t drain(const std::function<void(const std::vector<std::string_view>&)>& handler) override;
+
+    void setReadableCallback(std::function<void()> callback) override;
+
+private:
+    void run();
+
+    FrameLogReader log_;
+    ReplaySpeed speed_;
+    std::vector<std::size_t> frames_; // Indices of received records, in capture order
+
+    std::mutex mtx_; // Guards consumed_, finished_, stopping_, notifying_ and readableCallback_
+    std::condition_variable cv_; // Signals finished_, stopping_ and the end of a callback invocation
+    std::atomic<std::size_t> released_{0};
+    std::size_t consumed_ = 0;
+    bool finished_ = false;
+    bool stopping_ = false;
+    bool notifying_ = false; // The pacing thread is running readableCallback_
+    std::function<void()> readableCallback_;
+    std::thread pacer_;
+};
+
+#endif // REPLAY_TRANSPORT_H
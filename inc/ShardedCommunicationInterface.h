@@ -0,0 +1,138 @@
+// include/ShardedCommunicationInterface.h
+#ifndef SHARDED_COMMUNICATION_INTERFACE_H
+#define SHARDED_COMMUNICATION_INTERFACE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CommunicationInterface.h"
+#include "LockFreeQueue.h"
+
+/**
+ * @brief Share-nothing front end that partitions devices across per-core CommunicationInterface shards.
+ *
+ * A device belongs to shard FrameHeader::deviceHandle(deviceId) % shardCount. Each shard owns its
+ * CommunicationInterface with its own transport endpoint, cipher context, buffers and queues, and
+ * runs every call for its devices on one reactor thread pinned to a core. The shard installs its
+ * endpoint's readable callback, which only wakes the reactor; frames are drained and processed on
+ * the reactor. Callers and shards hand work to a shard only through its lock-free queue: frames
+ * arriving on another shard's endpoint are rerouted there on the header alone, before any cryptography.
+ */
+class ShardedCommunicationInterface {
+public:
+    using SecurityFactory = std::function<std::unique_ptr<ISecurity>(std::size_t shard)>;
+    using TransportFactory = std::function<std::unique_ptr<ITransport>(std::size_t shard)>;
+
+    /**
+     * @brief Creates the shards and starts their reactor threads.
+     *
+     * @param shardCount Number of shards; at least one is always created.
+     * @param securityFactory Creates the security module of each shard.
+     * @param transportFactory Creates the transport endpoint of each shard; empty uses the placeholder I/O.
+     * @throws std::invalid_argument if securityFactory is empty.
+     */
+    ShardedCommunicationInterface(std::size_t shardCount, SecurityFactory securityFactory,
+                                  TransportFactory transportFactory = nullptr);
+    ~ShardedCommunicationInterface();
+
+    ShardedCommunicationInterface(const ShardedCommunicationInterface&) = delete;
+    ShardedCommunicationInterface& operator=(const ShardedCommunicationInterface&) = delete;
+
+    /**
+     * @brief Sends a control command on the shard owning the device and waits for the result.
+     *
+     * @param deviceId The unique identifier of the target device.
+     * @param command The Command object to send.
+     * @return true if sending is successful, false otherwise.
+     */
+    bool sendControlCommand(const std::string& deviceId, const DataPacket::Command& command);
+
+    /**
+     * @brief Receives a state on the shard owning the device.
+     *
+     * The state is taken on the shard's reactor; the state callback then runs on the calling thread.
+     *
+     * @param deviceId The unique identifier of the source device.
+     * @param state The State object to populate with received data.
+     * @return true if receiving and processing is successful, false otherwise.
+     */
+    bool receiveState(const std::string& deviceId, DataPacket::State& state);
+
+    /**
+     * @brief Sets a callback function to handle received states; it runs on the thread that called receiveState.
+     *
+     * The callback never runs on a reactor, so it may send or receive for devices of any shard.
+     *
+     * @param callback A function that takes a const State& as parameter.
+     */
+    void setStateCallback(std::function<void(const DataPacket::State&)> callback);
+
+    /**
+     * @brief Returns the index of the shard owning a device.
+     *
+     * @param deviceId The unique identifier of the device.
+     * @return The shard index.
+     */
+    std::size_t shardOf(const std::string& deviceId) const;
+
+    /**
+     * @brief Returns the number of shards.
+     */
+    std::size_t shardCount() const {
+        return shards_.size();
+    }
+
+private:
+    using Job = std::function<void()>;
+
+    static constexpr std::size_t kQueueCapacity = 1024; // Jobs per shard queue
+
+    struct Shard {
+        explicit Shard(std::unique_ptr<CommunicationInterface> comm) : comm(std::move(comm)) {}
+
+        std::unique_ptr<CommunicationInterface> comm;
+        LockFreeQueue<Job> queue{kQueueCapacity};
+        std::atomic<std::uint32_t> doorbell{0}; // Bumped after every push; the reactor sleeps on it
+        std::atomic<bool> readable{false};      // Set by the endpoint's readable callback, cleared by the reactor's drain
+        std::atomic<bool> stopping{false};
+        std::thread reactor;
+    };
+
+    /**
+     * @brief Queues a job on a shard, waiting for room if its queue is full.
+     */
+    void post(Shard& shard, Job job);
+
+    /**
+     * @brief Runs a job on the shard owning a device and waits for its result.
+     *
+     * Must not be called from a reactor thread; no user callback runs on one.
+     */
+    bool call(const std::string& deviceId, std::function<bool(CommunicationInterface&)> job);
+
+    /**
+     * @brief Hands a frame received on the wrong shard to the shard owning its device.
+     */
+    void reroute(std::string_view frame);
+
+    /**
+     * @brief Reactor loop of one shard: pins the thread, then runs queued jobs in order.
+     *
+     * Frames reported readable are drained before the next job runs, so a job queued after a frame
+     * arrived on the shard's own endpoint sees its state.
+     */
+    static void run(Shard& shard, std::size_t core);
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::mutex callbackMutex_; // Guards stateCallback_
+    std::function<void(const DataPacket::State&)> stateCallback_;
+};
+
+#endif // SHARDED_COMMUNICATION_INTERFACE_H
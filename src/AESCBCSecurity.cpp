@@ -5,10 +5,22 @@
 #include <cryptopp/modes.h>
 #include <cryptopp/aes.h>
 #include <cryptopp/hex.h>
+#include <cryptopp/misc.h>
+#include <cryptopp/hkdf.h>
+#include <cryptopp/hmac.h>
+#include <cryptopp/sha.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <iostream>
 #include <cstring>
 
-AESCBCSecurity::AESCBCSecurity(const std::string& keyHex) {
+AESCBCSecurity::AESCBCSecurity(const std::string& keyHex, std::size_t batchWorkers)
+    : batchWorkers_(std::max<std::size_t>(batchWorkers, 1)) {
+    if (batchWorkers_ > 1) {
+        batchPool_ = std::make_unique<Executor>(batchWorkers_ - 1);
+    }
     // Decode the hexadecimal key string to bytes
     CryptoPP::HexDecoder decoder;
     decoder.Put(reinterpret_cast<const unsigned char*>(keyHex.data()), keyHex.size());
@@ -21,11 +33,19 @@ AESCBCSecurity::AESCBCSecurity(const std::string& keyHex) {
 
     key_.resize(CryptoPP::AES::DEFAULT_KEYLENGTH);
     decoder.Get(key_, key_.size());
+
+    // Derive a separate key for authentication rather than reusing the cipher key
+    static const char macInfo[] = "CommunicationInterface frame authentication";
+    macKey_.resize(CryptoPP::SHA256::DIGESTSIZE);
+    CryptoPP::HKDF<CryptoPP::SHA256> hkdf;
+    hkdf.DeriveKey(macKey_, macKey_.size(), key_, key_.size(), nullptr, 0,
+                   reinterpret_cast<const CryptoPP::byte*>(macInfo), sizeof(macInfo) - 1);
 }
 
 AESCBCSecurity::~AESCBCSecurity() {
     // clean up the memory for security and memory safety
     CryptoPP::SecureWipeArray(key_.BytePtr(), key_.size());
+    CryptoPP::SecureWipeArray(macKey_.BytePtr(), macKey_.size());
 }
 
 std::string AESCBCSecurity::encrypt(const std::string& plainText) {
@@ -58,7 +78,7 @@ std::string AESCBCSecurity::encrypt(const std::string& plainText) {
     return ivStr + cipherText;
 }
 
-std::string AESCBCSecurity::decrypt(const std::string& cipherText) {
+std::string AESCBCSecurity::decrypt(std::string_view cipherText) {
     using namespace CryptoPP;
 
     if (cipherText.size() < AES::BLOCKSIZE) {
@@ -90,3 +110,176 @@ std::string AESCBCSecurity::decrypt(const std::string& cipherText) {
 
     return plainText;
 }
+
+std::vector<std::string> AESCBCSecurity::decryptBatch(const std::vector<std::string_view>& cipherTexts) {
+    using namespace CryptoPP;
+
+    std::vector<std::string> plainTexts(cipherTexts.size());
+
+    // Lay out the ciphertext blocks of every well-formed frame (IVs excluded) in one output buffer
+    std::vector<size_t> offsets(cipherTexts.size());
+    std::vector<bool> wellFormed(cipherTexts.size(), false);
+    size_t totalSize = 0;
+    for (size_t i = 0; i < cipherTexts.size(); ++i) {
+        size_t size = cipherTexts[i].size();
+        if (size < 2 * AES::BLOCKSIZE || size % AES::BLOCKSIZE != 0) {
+            std::cerr << "Cipher text has invalid length." << std::endl;
+            continue;
+        }
+        wellFormed[i] = true;
+        offsets[i] = totalSize;
+        totalSize += size - AES::BLOCKSIZE;
+    }
+    if (totalSize == 0) {
+        return plainTexts;
+    }
+
+    // Short frames are copied together so one ECB call keeps the AES-NI pipeline full across them;
+    // longer frames fill it on their own and are decrypted straight from their views, e.g. into a
+    // memory-mapped replay log, without a copy
+    size_t gatheredSize = 0;
+    for (size_t i = 0; i < cipherTexts.size(); ++i) {
+        if (wellFormed[i] && cipherTexts[i].size() - AES::BLOCKSIZE < kDirectFrameBytes) {
+            gatheredSize += cipherTexts[i].size() - AES::BLOCKSIZE;
+        }
+    }
+    SecByteBlock gathered(gatheredSize);
+    SecByteBlock decrypted(totalSize);
+
+    // Segments map runs of the output buffer to their source bytes; runs with contiguous sources are merged
+    struct Segment {
+        size_t begin;
+        const byte* source;
+        size_t size;
+    };
+    std::vector<Segment> segments;
+    size_t gatheredOffset = 0;
+    for (size_t i = 0; i < cipherTexts.size(); ++i) {
+        if (!wellFormed[i]) {
+            continue;
+        }
+        size_t size = cipherTexts[i].size() - AES::BLOCKSIZE;
+        const byte* source = reinterpret_cast<const byte*>(cipherTexts[i].data()) + AES::BLOCKSIZE;
+        if (size < kDirectFrameBytes) {
+            std::memcpy(gathered + gatheredOffset, source, size);
+            source = gathered + gatheredOffset;
+            gatheredOffset += size;
+        }
+        if (!segments.empty() && segments.back().source + segments.back().size == source) {
+            segments.back().size += size;
+        } else {
+            segments.push_back({offsets[i], source, size});
+        }
+    }
+
+    // Large batches are split on block boundaries across the persistent batch pool
+    std::atomic<bool> failed{false};
+    auto decryptRange = [&](size_t begin, size_t end) {
+        try {
+            ECB_Mode<AES>::Decryption decryption(key_, key_.size());
+            auto segment = std::upper_bound(segments.begin(), segments.end(), begin,
+                                            [](size_t offset, const Segment& s) { return offset < s.begin; }) - 1;
+            for (; segment != segments.end() && segment->begin < end; ++segment) {
+                size_t from = std::max(begin, segment->begin);
+                size_t to = std::min(end, segment->begin + segment->size);
+                decryption.ProcessData(decrypted + from, segment->source + (from - segment->begin), to - from);
+            }
+        }
+        catch (const Exception& e) {
+            std::cerr << "Decryption error: " << e.what() << std::endl;
+            failed = true;
+        }
+    };
+
+    size_t workers = std::min(batchWorkers_, std::max<size_t>(totalSize / kParallelBatchBytes, 1));
+    size_t totalBlocks = totalSize / AES::BLOCKSIZE;
+    size_t blocksPerWorker = (totalBlocks + workers - 1) / workers;
+    std::mutex doneMtx;
+    std::condition_variable doneCv;
+    size_t pending = 0;
+    for (size_t w = 1; w < workers; ++w) {
+        size_t begin = std::min(w * blocksPerWorker, totalBlocks) * AES::BLOCKSIZE;
+        size_t end = std::min((w + 1) * blocksPerWorker, totalBlocks) * AES::BLOCKSIZE;
+        if (begin < end) {
+            {
+                std::lock_guard<std::mutex> lock(doneMtx);
+                ++pending;
+            }
+            batchPool_->post([&, begin, end]() {
+                decryptRange(begin, end);
+                std::lock_guard<std::mutex> lock(doneMtx);
+                if (--pending == 0) {
+                    doneCv.notify_one();
+                }
+            });
+        }
+    }
+    decryptRange(0, std::min(blocksPerWorker, totalBlocks) * AES::BLOCKSIZE);
+    {
+        // The shares refer to this frame's locals, so wait for every one of them
+        std::unique_lock<std::mutex> lock(doneMtx);
+        doneCv.wait(lock, [&]() { return pending == 0; });
+    }
+    if (failed) {
+        return std::vector<std::string>(cipherTexts.size());
+    }
+
+    // Undo the CBC chaining: each block is XORed with the previous ciphertext block, the first with the IV
+    for (size_t i = 0; i < cipherTexts.size(); ++i) {
+        if (!wellFormed[i]) {
+            continue;
+        }
+        const byte* frame = reinterpret_cast<const byte*>(cipherTexts[i].data());
+        size_t size = cipherTexts[i].size() - AES::BLOCKSIZE;
+        byte* plain = decrypted + offsets[i];
+        xorbuf(plain, frame, size);
+
+        // Strip PKCS #7 padding, as StreamTransformationFilter does in decrypt()
+        byte padding = plain[size - 1];
+        bool validPadding = padding >= 1 && padding <= AES::BLOCKSIZE;
+        for (size_t p = 1; validPadding && p <= padding; ++p) {
+            validPadding = plain[size - p] == padding;
+        }
+        if (!validPadding) {
+            std::cerr << "Decryption error: invalid PKCS #7 block padding found" << std::endl;
+            continue;
+        }
+        plainTexts[i].assign(reinterpret_cast<const char*>(plain), size - padding);
+    }
+
+    return plainTexts;
+}
+
+std::string AESCBCSecurity::authenticate(std::string_view message) {
+    using namespace CryptoPP;
+
+    std::string tag(kTagSize, '\0');
+    try {
+        HMAC<SHA256> hmac(macKey_, macKey_.size());
+        hmac.Update(reinterpret_cast<const byte*>(message.data()), message.size());
+        hmac.TruncatedFinal(reinterpret_cast<byte*>(&tag[0]), tag.size());
+    }
+    catch (const Exception& e) {
+        std::cerr << "Authentication error: " << e.what() << std::endl;
+        return "";
+    }
+    return tag;
+}
+
+bool AESCBCSecurity::verify(std::string_view message, std::string_view tag) {
+    using namespace CryptoPP;
+
+    if (tag.size() != kTagSize) {
+        return false;
+    }
+    try {
+        HMAC<SHA256> hmac(macKey_, macKey_.size());
+        hmac.Update(reinterpret_cast<const byte*>(message.data()), message.size());
+        // TruncatedVerify compares in constant time
+        return hmac.TruncatedVerify(reinterpret_cast<const byte*>(tag.data()), tag.size());
+    }
+    catch (const Exception& e) {
+        std::cerr << "Authentication error: " << e.what() << std::endl;
+        return false;
+    }
+}
@@ -0,0 +1,61 @@
+#include "CommandScheduler.h"
+#include <algorithm>
+
+CommandScheduler::CommandScheduler(std::size_t bulkWorkers) {
+    bulkWorkers = std::max<std::size_t>(bulkWorkers, 1);
+    workers_.reserve(bulkWorkers + 1);
+    workers_.emplace_back([this]() { run(true); });
+    for (std::size_t i = 0; i < bulkWorkers; ++i) {
+        workers_.emplace_back([this]() { run(false); });
+    }
+}
+
+CommandScheduler::~CommandScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    urgentCv_.notify_all();
+    workCv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void CommandScheduler::submit(CommandPriority priority, std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        (priority == CommandPriority::Urgent ? urgent_ : bulk_).push_back(std::move(job));
+    }
+    if (priority == CommandPriority::Urgent) {
+        // Whichever of the reserved worker and an idle bulk worker wakes first takes it
+        urgentCv_.notify_one();
+    }
+    workCv_.notify_one();
+}
+
+void CommandScheduler::run(bool reserved) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (true) {
+        std::deque<std::function<void()>>* lane = nullptr;
+        if (!urgent_.empty()) {
+            lane = &urgent_;
+        } else if (!reserved && !bulk_.empty()) {
+            lane = &bulk_;
+        }
+
+        if (lane) {
+            std::function<void()> job = std::move(lane->front());
+            lane->pop_front();
+            lock.unlock();
+            job();
+            lock.lock();
+            continue;
+        }
+
+        if (stopping_) {
+            return;
+        }
+        (reserved ? urgentCv_ : workCv_).wait(lock);
+    }
+}
@@ -0,0 +1,118 @@
+#include "CommandTracker.h"
+#include <algorithm>
+
+CommandTracker::CommandTracker(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits)
+    : windowSize_(std::max<std::size_t>(windowSize, 1)), ackTimeout_(ackTimeout), maxRetransmits_(maxRetransmits) {
+}
+
+void CommandTracker::configure(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    windowSize_ = std::max<std::size_t>(windowSize, 1);
+    ackTimeout_ = ackTimeout;
+    maxRetransmits_ = maxRetransmits;
+}
+
+bool CommandTracker::reserve(std::uint64_t deviceHandle) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    DeviceWindow& device = devices_[deviceHandle];
+    if (device.reserved + device.inFlight.size() >= windowSize_) {
+        return false;
+    }
+    device.reserved++;
+    return true;
+}
+
+void CommandTracker::release(std::uint64_t deviceHandle) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    DeviceWindow& device = devices_[deviceHandle];
+    if (device.reserved > 0) {
+        device.reserved--;
+    }
+}
+
+void CommandTracker::track(const std::string& deviceId, std::uint64_t deviceHandle, std::uint64_t sequence, std::string frame) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    DeviceWindow& device = devices_[deviceHandle];
+    if (device.reserved > 0) {
+        device.reserved--;
+    }
+    device.deviceId = deviceId;
+    InFlight entry;
+    entry.frame = std::move(frame);
+    entry.deadline = Clock::now() + ackTimeout_;
+    entry.ackTimeout = ackTimeout_;
+    entry.maxRetransmits = maxRetransmits_;
+    device.inFlight.emplace(sequence, std::move(entry));
+}
+
+std::vector<CommandTracker::Completion> CommandTracker::acknowledge(std::uint64_t deviceHandle, std::uint64_t acknowledged,
+                                                                    std::uint64_t acknowledgedMask) {
+    std::vector<Completion> completed;
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = devices_.find(deviceHandle);
+    if (it == devices_.end()) {
+        return completed;
+    }
+    DeviceWindow& device = it->second;
+    auto end = device.inFlight.upper_bound(acknowledged);
+    for (auto entry = device.inFlight.begin(); entry != end;) {
+        std::uint64_t age = acknowledged - entry->first;
+        if (age >= 64) {
+            complete(device, entry->first, CommandStatus::Failed, completed);
+        } else if ((acknowledgedMask & (std::uint64_t(1) << age)) != 0) {
+            complete(device, entry->first, CommandStatus::Acknowledged, completed);
+        } else {
+            ++entry;
+            continue;
+        }
+        entry = device.inFlight.erase(entry);
+    }
+    return completed;
+}
+
+void CommandTracker::complete(DeviceWindow& device, std::uint64_t sequence, CommandStatus status, std::vector<Completion>& completions) {
+    completions.push_back({device.deviceId, sequence, status});
+    device.completed[sequence] = status;
+    if (device.completed.size() > kCompletedHistory) {
+        device.completed.erase(device.completed.begin());
+    }
+}
+
+std::vector<CommandTracker::Retransmission> CommandTracker::collectExpired(std::vector<Completion>& failed) {
+    std::vector<Retransmission> retransmissions;
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto now = Clock::now();
+    for (auto& [handle, device] : devices_) {
+        for (auto entry = device.inFlight.begin(); entry != device.inFlight.end();) {
+            InFlight& command = entry->second;
+            if (command.deadline > now) {
+                ++entry;
+                continue;
+            }
+            if (command.retransmits >= command.maxRetransmits) {
+                complete(device, entry->first, CommandStatus::Failed, failed);
+                entry = device.inFlight.erase(entry);
+                continue;
+            }
+            command.retransmits++;
+            command.deadline = now + command.ackTimeout;
+            retransmissions.push_back({device.deviceId, command.frame});
+            ++entry;
+        }
+    }
+    return retransmissions;
+}
+
+CommandStatus CommandTracker::status(std::uint64_t deviceHandle, std::uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = devices_.find(deviceHandle);
+    if (it == devices_.end() || sequence == 0) {
+        return CommandStatus::Unknown;
+    }
+    const DeviceWindow& device = it->second;
+    if (device.inFlight.count(sequence) != 0) {
+        return CommandStatus::Pending;
+    }
+    auto completed = device.completed.find(sequence);
+    return completed == device.completed.end() ? CommandStatus::Unknown : completed->second;
+}
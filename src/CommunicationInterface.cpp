@@ -1,17 +1,28 @@
 #include "CommunicationInterface.h"
+#include "BlockingCall.h"
 #include <iostream>
 #include <sstream>
+#include <algorithm>
 #include <nlohmann/json.hpp>
 
 // Constructor and Destructor
-CommunicationInterface::CommunicationInterface(std::unique_ptr<ISecurity> securityModule)
-    : securityModule_(std::move(securityModule)) {
+CommunicationInterface::CommunicationInterface(std::unique_ptr<ISecurity> securityModule, std::unique_ptr<ITransport> transport)
+    : securityModule_(std::move(securityModule)), transport_(std::move(transport)),
+      commandTracker_(kDefaultCommandWindow, kDefaultAckTimeout, kDefaultMaxRetransmits) {
 
     // Initialize communication channels of underlying networking platform
+    if (transport_) {
+        transport_->setReadableCallback([this]() { drainTransport(); });
+    }
 }
 
 CommunicationInterface::~CommunicationInterface() {
-    // Clean up resources if needed in later implementations
+    // Both return only once no callback or timer is still using this object
+    if (transport_) {
+        transport_->setReadableCallback(nullptr);
+    }
+    std::lock_guard<std::mutex> lock(lifetime_->mtx);
+    lifetime_->alive = false;
 }
 
 // Data Manipulation Methods
@@ -64,34 +75,36 @@ bool CommunicationInterface::decodeState(const std::string& jsonStr, DataPacket:
  * @return true if sending is successful, false otherwise.
  */
 bool CommunicationInterface::sendControlCommand(const std::string& deviceId, const DataPacket::Command& command) {
-    std::lock_guard<std::mutex> lock(mtx_);
-    try {
-        command.validate();
-    }
-    catch (const std::invalid_argument& e) {
-        std::cerr << "Validation error: " << e.what() << "\n";
-        return false;
-    }
-
-    std::string encoded = encodeCommand(deviceId, command);
     std::string encrypted;
-    if(securityModule_) {
-        encrypted = securityModule_->encrypt(encoded);
-    } else {
-        std::cerr << "Security module not initialized.\n";
-        return false;
-    }
-    // Logging for demonstration purposes
-    std::cout << "Encoded Command to be sent: " << encoded << "to device: " << deviceId << "\n";
-    
-    encrypted = securityModule_->encrypt(encoded);
-    if(encrypted.empty()) {
-        std::cerr << "Encryption failed.\n";
-        return false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!prepareCommand(deviceId, command, encrypted)) {
+            return false;
+        }
     }
+    // Outside the lock: a transport may deliver the reply inline, and its acknowledgement runs the command callback
     return sendData(deviceId, encrypted); // Pass deviceId to sendData
 }
 
+/**
+ * @brief Sends a control command on a priority lane and waits for the send to complete.
+ *
+ * @param deviceId The unique identifier of the target device.
+ * @param command The Command object to send.
+ * @param priority The lane to send the command on.
+ * @return true if sending is successful, false otherwise.
+ */
+bool CommunicationInterface::sendControlCommand(const std::string& deviceId, const DataPacket::Command& command, CommandPriority priority) {
+    std::call_once(schedulerOnce_, [this]() { scheduler_ = std::make_unique<CommandScheduler>(kBulkWorkers); });
+
+    return blockingCall([this, priority](std::function<void()> job) { scheduler_->submit(priority, std::move(job)); },
+                        [this, &deviceId, &command, priority]() {
+                            std::string encrypted;
+                            return prepareCommand(deviceId, command, encrypted, nullptr, priority) &&
+                                   sendData(deviceId, encrypted, priority);
+                        });
+}
+
 /**
  * @brief Receives state data, decrypts, decodes, and validates it.
  *
@@ -100,28 +113,75 @@ bool CommunicationInterface::sendControlCommand(const std::string& deviceId, con
  * @return true if receiving and processing is successful, false otherwise.
  */
 bool CommunicationInterface::receiveState(const std::string& deviceId, DataPacket::State& state) {
-    std::lock_guard<std::mutex> lock(mtx_);
+    bool received;
+    std::vector<CommandTracker::Completion> completions;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        received = takeState(deviceId, state, completions);
+    }
+    // Outside the lock, so the callbacks may call back into this interface
+    reportCompletions(completions);
+    if (received) {
+        notifyState(state);
+    }
+    return received;
+}
+
+/**
+ * @brief Takes the next state for a device from its mailbox, or receives and processes a placeholder frame.
+ *
+ * @param deviceId The unique identifier of the source device.
+ * @param state The State object to populate with received data.
+ * @param completions Populated with the tracked commands acknowledged by a placeholder frame.
+ * @return true if a state for the device was taken, false otherwise.
+ */
+bool CommunicationInterface::takeState(const std::string& deviceId, DataPacket::State& state,
+                                       std::vector<CommandTracker::Completion>& completions) {
+    if (transport_) {
+        // States are routed into per-device mailboxes as the transport reports them readable
+        {
+            std::lock_guard<std::mutex> inboxLock(inboxMutex_);
+            auto it = mailboxes_.find(deviceId);
+            if (it == mailboxes_.end()) {
+                std::cerr << "No state pending for device: " << deviceId << "\n";
+                return false;
+            }
+            state = std::move(it->second.front());
+            it->second.pop_front();
+            if (it->second.empty()) {
+                mailboxes_.erase(it);
+            }
+        }
+        return true;
+    }
+
     std::string encryptedData;
     if (!receiveData(encryptedData)) {
         std::cerr << "Failed to receive data.\n";
         return false;
     }
 
-    std::string decrypted;
-    if(securityModule_) {
-        decrypted = securityModule_->decrypt(encryptedData);
-    } else {
-        std::cerr << "Security module not initialized.\n";
+    // Header checks first: frames for other devices, replays and forgeries never reach AES or JSON
+    FrameHeader::Header header;
+    if (!FrameHeader::parse(encryptedData, header)) {
+        std::cerr << "Malformed frame header.\n";
+        captureFrame(FrameDirection::Received, "", encryptedData);
         return false;
     }
-
-    if(decrypted.empty()) {
-        std::cerr << "Decryption failed.\n";
+    if (header.deviceHandle != FrameHeader::deviceHandle(deviceId)) {
+        std::cerr << "Dropped frame addressed to another device.\n";
+        captureFrame(FrameDirection::Received, "", encryptedData);
+        return false;
+    }
+    if (!admitFrame(encryptedData, header)) {
+        captureFrame(FrameDirection::Received, "", encryptedData);
         return false;
     }
+    applyAcknowledgement(header, completions);
 
-    if(!decodeState(decrypted, state)) {
-        std::cerr << "Failed to decode state.\n";
+    bool processed = processFrame(encryptedData, state);
+    captureFrame(FrameDirection::Received, processed ? state.deviceId : std::string(), encryptedData);
+    if (!processed) {
         return false;
     }
 
@@ -131,14 +191,220 @@ bool CommunicationInterface::receiveState(const std::string& deviceId, DataPacke
         return false;
     }
 
-// Invoke callback if set
-    if (stateCallback_) {
-        stateCallback_(state);
+    return true;
+}
+
+/**
+ * @brief Sends a sequence-numbered command and tracks it until the device acknowledges it.
+ *
+ * @param deviceId The unique identifier of the target device.
+ * @param command The Command object to send.
+ * @return The command's sequence number, or 0 if it is invalid or the device's window is full.
+ */
+std::uint64_t CommunicationInterface::sendTrackedCommand(const std::string& deviceId, const DataPacket::Command& command) {
+    std::uint64_t handle = FrameHeader::deviceHandle(deviceId);
+    // Reserve the window slot before a sequence number is allocated, so a full window leaves no gap
+    if (!commandTracker_.reserve(handle)) {
+        std::cerr << "Command window full for device: " << deviceId << "\n";
+        return 0;
+    }
+
+    std::string frame;
+    std::uint64_t sequence = 0;
+    if (!prepareCommand(deviceId, command, frame, &sequence)) {
+        commandTracker_.release(handle);
+        return 0;
+    }
+
+    // Track before sending: on a fast link the acknowledgement can arrive before sendData returns
+    commandTracker_.track(deviceId, handle, sequence, frame);
+    if (!sendData(deviceId, frame)) {
+        std::cerr << "Failed to send command " << sequence << ", it will be retransmitted.\n";
+    }
+    return sequence;
+}
+
+/**
+ * @brief Reports the delivery state of a tracked command.
+ *
+ * @param deviceId The unique identifier of the target device.
+ * @param sequence The sequence number returned by sendTrackedCommand.
+ * @return The command's status.
+ */
+CommandStatus CommunicationInterface::commandStatus(const std::string& deviceId, std::uint64_t sequence) {
+    return commandTracker_.status(FrameHeader::deviceHandle(deviceId), sequence);
+}
+
+/**
+ * @brief Resends tracked commands whose acknowledgement is overdue.
+ *
+ * @return The number of frames retransmitted.
+ */
+std::size_t CommunicationInterface::retransmitExpired() {
+    std::vector<CommandTracker::Completion> failed;
+    std::vector<CommandTracker::Retransmission> retransmissions = commandTracker_.collectExpired(failed);
+    for (const auto& retransmission : retransmissions) {
+        sendData(retransmission.deviceId, retransmission.frame);
+    }
+    reportCompletions(failed);
+    return retransmissions.size();
+}
+
+/**
+ * @brief Sets the per-device window and retransmission policy of tracked commands.
+ *
+ * @param windowSize Maximum number of unacknowledged commands per device.
+ * @param ackTimeout Time to wait for an acknowledgement before retransmitting.
+ * @param maxRetransmits Retransmissions before a command is reported as failed.
+ */
+void CommunicationInterface::setCommandWindow(std::size_t windowSize, std::chrono::milliseconds ackTimeout, int maxRetransmits) {
+    commandTracker_.configure(windowSize, ackTimeout, maxRetransmits);
+}
+
+/**
+ * @brief Sets a callback invoked when a tracked command is acknowledged or fails.
+ *
+ * @param callback A function taking the device ID, the sequence number and the final status.
+ */
+void CommunicationInterface::setCommandCallback(std::function<void(const std::string&, std::uint64_t, CommandStatus)> callback) {
+    std::lock_guard<std::mutex> lock(commandCallbackMutex_);
+    commandCallback_ = std::move(callback);
+}
+
+/**
+ * @brief Waits until a state from the device arrives or the timeout expires.
+ *
+ * @param deviceId The unique identifier of the source device.
+ * @param state The State object to populate with received data.
+ * @param timeout How long to wait for a state before giving up.
+ * @return true if a state was received in time, false otherwise.
+ */
+bool CommunicationInterface::receiveState(const std::string& deviceId, DataPacket::State& state, std::chrono::milliseconds timeout) {
+    return receiveState(deviceId, state, std::chrono::steady_clock::now() + timeout);
+}
+
+/**
+ * @brief Waits until a state from the device arrives or the deadline passes.
+ *
+ * @param deviceId The unique identifier of the source device.
+ * @param state The State object to populate with received data.
+ * @param deadline When to stop waiting.
+ * @return true if a state was received in time, false otherwise.
+ */
+bool CommunicationInterface::receiveState(const std::string& deviceId, DataPacket::State& state, std::chrono::steady_clock::time_point deadline) {
+    if (!transport_) {
+        return receiveState(deviceId, state); // The placeholder receiveData never has to wait
+    }
+    return waitAny({deviceId}, state, deadline);
+}
+
+/**
+ * @brief Waits until a state from any of the devices arrives or the timeout expires.
+ *
+ * @param deviceIds The unique identifiers of the source devices.
+ * @param state The State object to populate with received data.
+ * @param timeout How long to wait for a state before giving up.
+ * @return true if a state was received in time, false otherwise.
+ */
+bool CommunicationInterface::waitAny(const std::vector<std::string>& deviceIds, DataPacket::State& state, std::chrono::milliseconds timeout) {
+    return waitAny(deviceIds, state, std::chrono::steady_clock::now() + timeout);
+}
+
+/**
+ * @brief Waits until a state from any of the devices arrives or the deadline passes.
+ *
+ * @param deviceIds The unique identifiers of the source devices.
+ * @param state The State object to populate with received data.
+ * @param deadline When to stop waiting.
+ * @return true if a state was received in time, false otherwise.
+ */
+bool CommunicationInterface::waitAny(const std::vector<std::string>& deviceIds, DataPacket::State& state, std::chrono::steady_clock::time_point deadline) {
+    if (!transport_) {
+        for (const auto& deviceId : deviceIds) {
+            if (receiveState(deviceId, state)) {
+                return true;
+            }
+        }
+        return false;
     }
 
+    {
+        // Sleep until deliverState puts a state for one of the devices into its mailbox
+        std::unique_lock<std::mutex> lock(inboxMutex_);
+        auto ready = mailboxes_.end();
+        blockedReceivers_++;
+        bool arrived = stateArrived_.wait_until(lock, deadline, [this, &deviceIds, &ready]() {
+            for (const auto& deviceId : deviceIds) {
+                ready = mailboxes_.find(deviceId);
+                if (ready != mailboxes_.end()) {
+                    return true;
+                }
+            }
+            return false;
+        });
+        blockedReceivers_--;
+        if (!arrived) {
+            std::cerr << "Timed out waiting for state from " << deviceIds.size() << " device(s).\n";
+            return false;
+        }
+        state = std::move(ready->second.front());
+        ready->second.pop_front();
+        if (ready->second.empty()) {
+            mailboxes_.erase(ready);
+        }
+    }
+    notifyState(state);
     return true;
 }
 
+/**
+ * @brief Awaitable version of sendControlCommand, resumed on the given executor.
+ *
+ * @param executor The executor the coroutine is resumed on.
+ * @param deviceId The unique identifier of the target device.
+ * @param command The Command object to send.
+ * @return true if sending is successful, false otherwise.
+ */
+Task<bool> CommunicationInterface::sendControlCommandAsync(Executor& executor, std::string deviceId, DataPacket::Command command) {
+    co_await executor.schedule();
+
+    std::string encrypted;
+    if (!prepareCommand(deviceId, command, encrypted)) {
+        co_return false;
+    }
+    co_return sendData(deviceId, encrypted);
+}
+
+/**
+ * @brief Awaitable version of receiveState, suspended until a state for the device arrives.
+ *
+ * @param executor The executor the coroutine is resumed on.
+ * @param deviceId The unique identifier of the source device.
+ * @param state The State object to populate with received data.
+ * @param timeout How long to wait for a state before giving up.
+ * @return true if a state was received in time, false otherwise.
+ */
+Task<bool> CommunicationInterface::receiveStateAsync(Executor& executor, std::string deviceId, DataPacket::State& state,
+                                                     std::chrono::milliseconds timeout) {
+    if (!transport_) {
+        co_await executor.schedule();
+        co_return receiveState(deviceId, state);
+    }
+
+    auto pending = std::make_shared<PendingReceive>();
+    pending->executor = &executor;
+    ReceiveAwaiter awaiter{*this, deviceId, pending, timeout};
+    co_await awaiter;
+
+    if (!pending->success) {
+        std::cerr << "Timed out waiting for state from device: " << deviceId << "\n";
+        co_return false;
+    }
+    state = std::move(pending->state);
+    notifyState(state);
+    co_return true;
+}
+
 /**
  * @brief Sets a callback function to handle received states.
  *
@@ -149,6 +415,58 @@ void CommunicationInterface::setStateCallback(std::function<void(const DataPacke
     stateCallback_ = callback;
 }
 
+/**
+ * @brief Starts appending every sent and received frame to a memory-mapped capture log.
+ *
+ * @param path Path of the log file; an existing file is truncated.
+ * @return true if capturing started, false if the log could not be created.
+ */
+bool CommunicationInterface::startCapture(const std::string& path) {
+    std::shared_ptr<FrameLogWriter> writer;
+    try {
+        writer = std::make_shared<FrameLogWriter>(path);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << "Capture error: " << e.what() << "\n";
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    capture_ = std::move(writer);
+    return true;
+}
+
+/**
+ * @brief Stops capturing and closes the capture log.
+ */
+void CommunicationInterface::stopCapture() {
+    std::lock_guard<std::mutex> lock(captureMutex_);
+    capture_.reset();
+}
+
+/**
+ * @brief Restricts which devices this interface accepts frames from.
+ *
+ * @param owns Returns true for device handles this interface accepts; empty accepts every device.
+ * @param reroute Receives frames from other devices, e.g. to forward them to the interface owning them.
+ */
+void CommunicationInterface::setDeviceScope(std::function<bool(std::uint64_t)> owns, std::function<void(std::string_view)> reroute) {
+    std::shared_ptr<const DeviceScope> scope;
+    if (owns) {
+        scope = std::make_shared<const DeviceScope>(DeviceScope{std::move(owns), std::move(reroute)});
+    }
+    std::lock_guard<std::mutex> lock(scopeMutex_);
+    deviceScope_ = std::move(scope);
+}
+
+/**
+ * @brief Enables or disables the console echo of encoded commands.
+ *
+ * @param enabled false to stop writing every encoded command to std::cout.
+ */
+void CommunicationInterface::setCommandEcho(bool enabled) {
+    commandEcho_ = enabled;
+}
+
 // Communication Methods (Platform-Agnostic Placeholder)
 
 /**
@@ -156,10 +474,18 @@ void CommunicationInterface::setStateCallback(std::function<void(const DataPacke
  *
  * @param deviceId The unique identifier of the target device.
  * @param data The encrypted data to send.
+ * @param priority The frame's lane; urgent frames are not echoed to the console.
  * @return true if sending is successful, false otherwise.
  */
-bool CommunicationInterface::sendData(const std::string& deviceId, const std::string& data) {
+bool CommunicationInterface::sendData(const std::string& deviceId, const std::string& data, CommandPriority priority) {
+    captureFrame(FrameDirection::Sent, deviceId, data);
+    if (transport_) {
+        return transport_->send(deviceId, data);
+    }
     // Placeholder: Simulate sending data to a specific device (e.g., via network, serial port, etc.)
+    if (priority == CommandPriority::Urgent || !commandEcho_) {
+        return true;
+    }
     std::cout << "Sending Encrypted Data to Device [" << deviceId << "]: " << data << "\n";
     return true;
 }
@@ -174,18 +500,430 @@ bool CommunicationInterface::receiveData(std::string& data) {
     // Simulate receiving encrypted data from a specific device
     // For demonstration, we'll simulate receiving from "device123"
     std::string samplePlainText = "{\"deviceId\": \"device123\", \"status\": \"OK\", \"value\": 42}";
+    std::string encrypted;
     if(securityModule_) {
-        data = securityModule_->encrypt(samplePlainText);
+        encrypted = securityModule_->encrypt(samplePlainText);
     } else {
         std::cerr << "Security module not initialized.\n";
         return false;
     }
     
-    if(data.empty()) {
+    if(encrypted.empty()) {
         std::cerr << "Failed to encrypt sample received data.\n";
         return false;
     }
 
+    // The simulated device has acted on every command sent to it so far
+    std::uint64_t handle = FrameHeader::deviceHandle("device123");
+    std::uint64_t acknowledged;
+    {
+        std::lock_guard<std::mutex> lock(sequenceMutex_);
+        auto sent = txSequences_.find(handle);
+        acknowledged = sent == txSequences_.end() ? 0 : sent->second;
+    }
+    data = FrameHeader::seal(*securityModule_, {FrameHeader::FrameType::State, handle, ++syntheticSequence_, acknowledged, ~std::uint64_t(0), sessionEpoch_}, encrypted);
+    if(data.empty()) {
+        std::cerr << "Failed to authenticate sample received data.\n";
+        return false;
+    }
+
     std::cout << "Received Encrypted Data: " << data << "\n";
     return true;
 }
+
+// Frame Processing Methods
+
+/**
+ * @brief Validates, encodes and encrypts a command into a frame ready for sendData.
+ *
+ * @param deviceId The unique identifier of the target device.
+ * @param command The Command object to prepare.
+ * @param frame Populated with the encrypted frame.
+ * @param sequence If not null, populated with the frame's sequence number.
+ * @param priority The command's lane; urgent commands are not echoed to the console.
+ * @return true if the frame was produced, false otherwise.
+ */
+bool CommunicationInterface::prepareCommand(const std::string& deviceId, const DataPacket::Command& command, std::string& frame,
+                                            std::uint64_t* sequence, CommandPriority priority) {
+    try {
+        command.validate();
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << "Validation error: " << e.what() << "\n";
+        return false;
+    }
+    // Logging for demonstration purposes; urgent commands skip it, as std::cout serializes under bulk load
+    bool echo = priority != CommandPriority::Urgent && commandEcho_;
+    if (echo) {
+        std::cout << "Command validated successfully.\n";
+    }
+
+    if(!securityModule_) {
+        std::cerr << "Security module not initialized.\n";
+        return false;
+    }
+
+    std::string encoded = encodeCommand(deviceId, command);
+    if (echo) {
+        std::cout << "Encoded Command to be sent: " << encoded << "to device: " << deviceId << "\n";
+    }
+
+    std::string encrypted = securityModule_->encrypt(encoded);
+    if(encrypted.empty()) {
+        std::cerr << "Encryption failed.\n";
+        return false;
+    }
+
+    std::uint64_t handle = FrameHeader::deviceHandle(deviceId);
+    std::uint64_t next = nextSequence(handle);
+    frame = FrameHeader::seal(*securityModule_, {FrameHeader::FrameType::Command, handle, next, 0, 0, sessionEpoch_}, encrypted);
+    if(frame.empty()) {
+        std::cerr << "Failed to authenticate frame.\n";
+        return false;
+    }
+    if (sequence) {
+        *sequence = next;
+    }
+    return true;
+}
+
+/**
+ * @brief Decrypts and decodes an admitted frame into a State object.
+ *
+ * @param frame The complete frame, already admitted by admitFrame.
+ * @param state The State object to populate.
+ * @return true if the frame holds a valid state, false otherwise.
+ */
+bool CommunicationInterface::processFrame(std::string_view frame, DataPacket::State& state) {
+    return decodeFrame(securityModule_->decrypt(FrameHeader::payload(frame)), state);
+}
+
+/**
+ * @brief Checks that a frame is a State frame, then its sequence number against the replay window, then its tag.
+ *
+ * @param frame The complete frame.
+ * @param header The header fields already read from the frame.
+ * @return true if the frame is fresh and authentic, false otherwise.
+ */
+bool CommunicationInterface::admitFrame(std::string_view frame, const FrameHeader::Header& header) {
+    // A Command frame here is one of ours reflected back: it would verify, and its epoch would reset the device's window
+    if (header.type != FrameHeader::FrameType::State) {
+        std::cerr << "Dropped frame that is not a State frame.\n";
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(sequenceMutex_);
+        auto window = rxWindows_.find(header.deviceHandle);
+        bool fresh = window == rxWindows_.end() ? header.sequence != 0 : window->second.check(header.epoch, header.sequence);
+        if (!fresh) {
+            std::cerr << "Dropped replayed frame.\n";
+            return false;
+        }
+    }
+
+    if(!securityModule_) {
+        std::cerr << "Security module not initialized.\n";
+        return false;
+    }
+    if (!FrameHeader::verify(*securityModule_, frame)) {
+        std::cerr << "Dropped frame with invalid authentication tag.\n";
+        return false;
+    }
+
+    // Re-check under the lock: a concurrent drain may have accepted the same sequence number meanwhile
+    std::lock_guard<std::mutex> lock(sequenceMutex_);
+    FrameHeader::ReplayWindow& window = rxWindows_[header.deviceHandle];
+    if (!window.check(header.epoch, header.sequence)) {
+        std::cerr << "Dropped replayed frame.\n";
+        return false;
+    }
+    window.update(header.epoch, header.sequence);
+    return true;
+}
+
+/**
+ * @brief Completes tracked commands marked in the selective acknowledgement of an admitted State frame.
+ *
+ * @param header The header fields of the admitted frame.
+ * @param completions Appended with the completed commands, for the caller to report once it holds no lock.
+ */
+void CommunicationInterface::applyAcknowledgement(const FrameHeader::Header& header,
+                                                  std::vector<CommandTracker::Completion>& completions) {
+    if (header.acknowledged != 0) {
+        std::vector<CommandTracker::Completion> acknowledged =
+            commandTracker_.acknowledge(header.deviceHandle, header.acknowledged, header.acknowledgedMask);
+        completions.insert(completions.end(), acknowledged.begin(), acknowledged.end());
+    }
+}
+
+/**
+ * @brief Invokes the command callback, if set, for each completed command.
+ *
+ * @param completions The acknowledged or failed commands.
+ */
+void CommunicationInterface::reportCompletions(const std::vector<CommandTracker::Completion>& completions) {
+    if (completions.empty()) {
+        return;
+    }
+    std::function<void(const std::string&, std::uint64_t, CommandStatus)> callback;
+    {
+        std::lock_guard<std::mutex> lock(commandCallbackMutex_);
+        callback = commandCallback_;
+    }
+    if (callback) {
+        for (const auto& completion : completions) {
+            callback(completion.deviceId, completion.sequence, completion.status);
+        }
+    }
+}
+
+/**
+ * @brief Returns the next outgoing sequence number for a device.
+ *
+ * @param deviceHandle The handle of the target device.
+ * @return The sequence number, starting at 1.
+ */
+std::uint64_t CommunicationInterface::nextSequence(std::uint64_t deviceHandle) {
+    std::lock_guard<std::mutex> lock(sequenceMutex_);
+    return ++txSequences_[deviceHandle];
+}
+
+/**
+ * @brief Decodes an already decrypted frame into a State object.
+ *
+ * @param decrypted The decrypted frame; empty if decryption failed.
+ * @param state The State object to populate.
+ * @return true if the frame holds a valid state, false otherwise.
+ */
+bool CommunicationInterface::decodeFrame(const std::string& decrypted, DataPacket::State& state) {
+    if(decrypted.empty()) {
+        std::cerr << "Decryption failed.\n";
+        return false;
+    }
+
+    if(!decodeState(decrypted, state)) {
+        std::cerr << "Failed to decode state.\n";
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Appends a frame to the capture log if capturing is active.
+ *
+ * @param direction Whether the frame was sent or received.
+ * @param deviceId The device the frame belongs to, empty if unknown.
+ * @param frame The encrypted frame.
+ */
+void CommunicationInterface::captureFrame(FrameDirection direction, std::string_view deviceId, std::string_view frame) {
+    std::shared_ptr<FrameLogWriter> capture;
+    {
+        std::lock_guard<std::mutex> lock(captureMutex_);
+        capture = capture_;
+    }
+    if (capture && !capture->append(direction, deviceId, frame)) {
+        std::cerr << "Failed to capture frame.\n";
+    }
+}
+
+/**
+ * @brief Invokes the state callback, if set, for a state handed to a caller.
+ *
+ * @param state The received state.
+ */
+void CommunicationInterface::notifyState(const DataPacket::State& state) {
+    std::function<void(const DataPacket::State&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        callback = stateCallback_;
+    }
+    if (callback) {
+        callback(state);
+    }
+}
+
+// Asynchronous Delivery
+
+/**
+ * @brief Completes immediately from the mailbox, or parks the coroutine until a state or the timeout arrives.
+ *
+ * @param handle The awaiting coroutine.
+ * @return false to continue without suspending, true once the coroutine is parked.
+ */
+bool CommunicationInterface::ReceiveAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(comm.inboxMutex_);
+    auto mailbox = comm.mailboxes_.find(deviceId);
+    if (mailbox != comm.mailboxes_.end()) {
+        pending->state = std::move(mailbox->second.front());
+        pending->success = true;
+        mailbox->second.pop_front();
+        if (mailbox->second.empty()) {
+            comm.mailboxes_.erase(mailbox);
+        }
+        return false;
+    }
+
+    pending->handle = handle;
+    comm.waiters_[deviceId].push_back(pending);
+
+    // Arm the timeout while still holding the lock: once it is released the
+    // coroutine may be resumed elsewhere and this awaiter must not be touched
+    // The timer stays queued after the receive completes, so it checks the interface still exists
+    CommunicationInterface* self = &comm;
+    std::weak_ptr<Lifetime> lifetime = comm.lifetime_;
+    pending->timer = pending->executor->postAfter(timeout, [self, lifetime, id = deviceId, pending = pending]() {
+        std::shared_ptr<Lifetime> owner = lifetime.lock();
+        if (!owner) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(owner->mtx);
+        if (owner->alive) {
+            self->expireReceive(id, pending);
+        }
+    });
+    return true;
+}
+
+/**
+ * @brief Drains every readable frame from the transport and hands them to ingestFrames.
+ */
+void CommunicationInterface::drainTransport() {
+    if (!transport_) {
+        return;
+    }
+    transport_->drain([this](const std::vector<std::string_view>& frames) { ingestFrames(frames); });
+}
+
+/**
+ * @brief Processes frames that arrived outside the attached transport, e.g. rerouted by another interface.
+ *
+ * @param frames The complete frames, valid for the duration of the call.
+ */
+void CommunicationInterface::ingestFrames(const std::vector<std::string_view>& frames) {
+    if(!securityModule_) {
+        std::cerr << "Security module not initialized.\n";
+        return;
+    }
+    std::shared_ptr<const DeviceScope> scope;
+    {
+        std::lock_guard<std::mutex> lock(scopeMutex_);
+        scope = deviceScope_;
+    }
+
+    // Header pass: reroute or drop frames before any AES or JSON work
+    std::vector<std::string_view> admitted;
+    std::vector<std::string_view> payloads;
+    std::vector<std::uint64_t> handles;
+    std::vector<CommandTracker::Completion> completions;
+    admitted.reserve(frames.size());
+    payloads.reserve(frames.size());
+    handles.reserve(frames.size());
+    for (std::string_view frame : frames) {
+        FrameHeader::Header header;
+        if (!FrameHeader::parse(frame, header)) {
+            std::cerr << "Malformed frame header.\n";
+            captureFrame(FrameDirection::Received, "", frame);
+            continue;
+        }
+        if (scope && scope->owns && !scope->owns(header.deviceHandle)) {
+            if (scope->reroute) {
+                scope->reroute(frame);
+            }
+            continue;
+        }
+        if (!admitFrame(frame, header)) {
+            captureFrame(FrameDirection::Received, "", frame);
+            continue;
+        }
+        applyAcknowledgement(header, completions);
+        admitted.push_back(frame);
+        payloads.push_back(FrameHeader::payload(frame));
+        handles.push_back(header.deviceHandle);
+    }
+    reportCompletions(completions);
+    if (payloads.empty()) {
+        return;
+    }
+
+    std::vector<std::string> decrypted = securityModule_->decryptBatch(payloads);
+    for (std::size_t i = 0; i < admitted.size(); ++i) {
+        DataPacket::State state;
+        bool processed = decodeFrame(decrypted[i], state);
+        captureFrame(FrameDirection::Received, processed ? state.deviceId : std::string(), admitted[i]);
+        if (!processed) {
+            continue;
+        }
+        if (FrameHeader::deviceHandle(state.deviceId) != handles[i]) {
+            std::cerr << "Frame header does not match device: " << state.deviceId << "\n";
+            continue;
+        }
+        deliverState(std::move(state));
+    }
+}
+
+/**
+ * @brief Hands a state to the oldest pending receive for its device, or queues it in the mailbox and wakes blocked receivers.
+ *
+ * @param state The decoded state.
+ */
+void CommunicationInterface::deliverState(DataPacket::State state) {
+    std::shared_ptr<PendingReceive> pending;
+    bool wakeBlocked = false;
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        auto waiters = waiters_.find(state.deviceId);
+        if (waiters == waiters_.end()) {
+            auto& mailbox = mailboxes_[state.deviceId];
+            if (mailbox.size() >= kMaxMailboxDepth) {
+                mailbox.pop_front();
+            }
+            mailbox.push_back(std::move(state));
+            wakeBlocked = blockedReceivers_ > 0;
+        } else {
+            pending = std::move(waiters->second.front());
+            waiters->second.pop_front();
+            if (waiters->second.empty()) {
+                waiters_.erase(waiters);
+            }
+        }
+    }
+    if (!pending) {
+        // Blocked receivers may wait on different devices, so each re-checks its own mailboxes
+        if (wakeBlocked) {
+            stateArrived_.notify_all();
+        }
+        return;
+    }
+    // The timeout is no longer needed; drop it rather than leave it, and the state it holds, queued until the deadline
+    pending->executor->cancel(pending->timer);
+    pending->state = std::move(state);
+    pending->success = true;
+    pending->executor->resume(pending->handle);
+}
+
+/**
+ * @brief Fails a pending receive whose timeout expired before a state arrived.
+ *
+ * @param deviceId The device the receive is waiting on.
+ * @param pending The pending receive.
+ */
+void CommunicationInterface::expireReceive(const std::string& deviceId, const std::shared_ptr<PendingReceive>& pending) {
+    {
+        std::lock_guard<std::mutex> lock(inboxMutex_);
+        auto waiters = waiters_.find(deviceId);
+        if (waiters == waiters_.end()) {
+            return; // Already completed by deliverState
+        }
+        auto& queue = waiters->second;
+        auto it = std::find(queue.begin(), queue.end(), pending);
+        if (it == queue.end()) {
+            return;
+        }
+        queue.erase(it);
+        if (queue.empty()) {
+            waiters_.erase(waiters);
+        }
+    }
+    pending->success = false;
+    pending->executor->resume(pending->handle);
+}
@@ -0,0 +1,90 @@
+#include "Executor.h"
+#include <algorithm>
+
+Executor::Executor(std::size_t threadCount) {
+    threadCount = std::max<std::size_t>(threadCount, 1);
+    workers_.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers_.emplace_back([this]() { run(); });
+    }
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void Executor::post(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        tasks_.push_back(std::move(task));
+    }
+    cv_.notify_one();
+}
+
+Executor::TimerId Executor::postAfter(Clock::duration delay, std::function<void()> task) {
+    TimerId id;
+    bool earliest;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        id = ++nextTimer_;
+        auto timer = timers_.emplace(Clock::now() + delay, std::make_pair(id, std::move(task)));
+        timerIndex_.emplace(id, timer);
+        earliest = timer == timers_.begin();
+    }
+    // Sleeping workers already wake for an earlier deadline; one of them must re-evaluate a new earliest one
+    if (earliest) {
+        cv_.notify_one();
+    }
+    return id;
+}
+
+bool Executor::cancel(TimerId timer) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = timerIndex_.find(timer);
+    if (it == timerIndex_.end()) {
+        return false;
+    }
+    timers_.erase(it->second);
+    timerIndex_.erase(it);
+    return true;
+}
+
+std::size_t Executor::pendingTimers() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return timers_.size();
+}
+
+void Executor::run() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    while (!stopping_) {
+        // Promote expired timers to the ready queue
+        auto now = Clock::now();
+        while (!timers_.empty() && timers_.begin()->first <= now) {
+            timerIndex_.erase(timers_.begin()->second.first);
+            tasks_.push_back(std::move(timers_.begin()->second.second));
+            timers_.erase(timers_.begin());
+        }
+
+        if (!tasks_.empty()) {
+            std::function<void()> task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            continue;
+        }
+
+        if (timers_.empty()) {
+            cv_.wait(lock);
+        } else {
+            cv_.wait_until(lock, timers_.begin()->first);
+        }
+    }
+}
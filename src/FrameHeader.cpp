@@ -0,0 +1,90 @@
+#include "FrameHeader.h"
+#include <algorithm>
+#include <chrono>
+
+namespace FrameHeader {
+
+namespace {
+
+constexpr std::size_t kVersionOffset = kTagSize;
+constexpr std::size_t kTypeOffset = kVersionOffset + 1;
+constexpr std::size_t kEpochOffset = kTypeOffset + 1;
+constexpr std::size_t kHandleOffset = kEpochOffset + 8;
+constexpr std::size_t kSequenceOffset = kHandleOffset + 8;
+constexpr std::size_t kAcknowledgedOffset = kSequenceOffset + 8;
+constexpr std::size_t kAcknowledgedMaskOffset = kAcknowledgedOffset + 8;
+
+void putUint64(std::string& out, std::size_t offset, std::uint64_t value) {
+    for (std::size_t i = 0; i < 8; ++i) {
+        out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+std::uint64_t getUint64(std::string_view in, std::size_t offset) {
+    std::uint64_t value = 0;
+    for (std::size_t i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+std::uint64_t deviceHandle(std::string_view deviceId) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : deviceId) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::uint64_t newEpoch() {
+    auto now = std::chrono::system_clock::now().time_since_epoch();
+    return std::max<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(), 1);
+}
+
+std::string seal(ISecurity& security, const Header& header, std::string_view payload) {
+    std::string frame(kSize, '\0');
+    frame[kVersionOffset] = static_cast<char>(kVersion);
+    frame[kTypeOffset] = static_cast<char>(header.type);
+    putUint64(frame, kEpochOffset, header.epoch);
+    putUint64(frame, kHandleOffset, header.deviceHandle);
+    putUint64(frame, kSequenceOffset, header.sequence);
+    putUint64(frame, kAcknowledgedOffset, header.acknowledged);
+    putUint64(frame, kAcknowledgedMaskOffset, header.acknowledgedMask);
+    frame.append(payload.data(), payload.size());
+
+    std::string tag = security.authenticate(std::string_view(frame).substr(kTagSize));
+    if (tag.size() != kTagSize) {
+        return "";
+    }
+    frame.replace(0, kTagSize, tag);
+    return frame;
+}
+
+bool parse(std::string_view frame, Header& header) {
+    if (frame.size() < kSize || static_cast<std::uint8_t>(frame[kVersionOffset]) != kVersion) {
+        return false;
+    }
+    auto type = static_cast<FrameType>(static_cast<std::uint8_t>(frame[kTypeOffset]));
+    if (type != FrameType::Command && type != FrameType::State) {
+        return false;
+    }
+    header.type = type;
+    header.epoch = getUint64(frame, kEpochOffset);
+    header.deviceHandle = getUint64(frame, kHandleOffset);
+    header.sequence = getUint64(frame, kSequenceOffset);
+    header.acknowledged = getUint64(frame, kAcknowledgedOffset);
+    header.acknowledgedMask = getUint64(frame, kAcknowledgedMaskOffset);
+    return true;
+}
+
+bool verify(ISecurity& security, std::string_view frame) {
+    if (frame.size() < kSize) {
+        return false;
+    }
+    return security.verify(frame.substr(kTagSize), frame.substr(0, kTagSize));
+}
+
+} // namespace FrameHeader
@@ -0,0 +1,196 @@
+#include "FrameLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr char kMagic[4] = {'C', 'I', 'F', 'L'};
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kInitialCapacity = 1 << 20; // 1 MiB, doubled as needed
+
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t dataSize; // Bytes of complete records following the header
+};
+
+struct RecordHeader {
+    std::uint64_t timestampNs; // steady_clock, relative to the log's creation
+    std::uint64_t wallClockNs; // system_clock, since the epoch
+    std::uint32_t frameSize;
+    std::uint16_t deviceIdSize;
+    std::uint8_t direction;
+    std::uint8_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader must be 16 bytes");
+static_assert(sizeof(RecordHeader) == 24, "RecordHeader must be 24 bytes");
+
+std::size_t paddedRecordSize(std::size_t deviceIdSize, std::size_t frameSize) {
+    return (sizeof(RecordHeader) + deviceIdSize + frameSize + 7) & ~static_cast<std::size_t>(7);
+}
+
+} // namespace
+
+// FrameLogWriter
+
+FrameLogWriter::FrameLogWriter(const std::string& path) : created_(std::chrono::steady_clock::now()) {
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        throw std::runtime_error("Cannot create frame log: " + path);
+    }
+    if (!reserve(kInitialCapacity)) {
+        ::close(fd_);
+        throw std::runtime_error("Cannot map frame log: " + path);
+    }
+
+    FileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dataSize = 0;
+    std::memcpy(base_, &header, sizeof(header));
+    used_ = sizeof(FileHeader);
+}
+
+FrameLogWriter::~FrameLogWriter() {
+    if (base_) {
+        ::munmap(base_, capacity_);
+    }
+    if (fd_ >= 0) {
+        // Drop the unused preallocated tail; if this fails, the header's data size still bounds readers
+        int result = ::ftruncate(fd_, static_cast<off_t>(used_));
+        (void)result;
+        ::close(fd_);
+    }
+}
+
+bool FrameLogWriter::reserve(std::size_t bytes) {
+    if (bytes <= capacity_) {
+        return true;
+    }
+    std::size_t newCapacity = std::max(capacity_ * 2, kInitialCapacity);
+    while (newCapacity < bytes) {
+        newCapacity *= 2;
+    }
+    if (::ftruncate(fd_, static_cast<off_t>(newCapacity)) != 0) {
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, newCapacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+    if (base_) {
+        ::munmap(base_, capacity_);
+    }
+    base_ = static_cast<unsigned char*>(mapping);
+    capacity_ = newCapacity;
+    return true;
+}
+
+bool FrameLogWriter::append(FrameDirection direction, std::string_view deviceId, std::string_view frame) {
+    if (deviceId.size() > UINT16_MAX || frame.size() > UINT32_MAX) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    std::size_t recordSize = paddedRecordSize(deviceId.size(), frame.size());
+    if (!reserve(used_ + recordSize)) {
+        return false;
+    }
+
+    RecordHeader header{};
+    // Read the monotonic clock under the lock, so timestamps are non-decreasing in log order
+    header.timestampNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - created_).count());
+    header.wallClockNs = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    header.frameSize = static_cast<std::uint32_t>(frame.size());
+    header.deviceIdSize = static_cast<std::uint16_t>(deviceId.size());
+    header.direction = static_cast<std::uint8_t>(direction);
+
+    unsigned char* out = base_ + used_;
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header), deviceId.data(), deviceId.size());
+    std::memcpy(out + sizeof(header) + deviceId.size(), frame.data(), frame.size());
+    used_ += recordSize;
+
+    // Commit only after the record is complete
+    std::uint64_t dataSize = used_ - sizeof(FileHeader);
+    std::memcpy(base_ + offsetof(FileHeader, dataSize), &dataSize, sizeof(dataSize));
+    return true;
+}
+
+// FrameLogReader
+
+FrameLogReader::FrameLogReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open frame log: " + path);
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        throw std::runtime_error("Frame log too short: " + path);
+    }
+    mappedSize_ = static_cast<std::size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, mappedSize_, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map frame log: " + path);
+    }
+    base_ = static_cast<const unsigned char*>(mapping);
+
+    FileHeader header;
+    std::memcpy(&header, base_, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion) {
+        ::munmap(const_cast<unsigned char*>(base_), mappedSize_);
+        throw std::runtime_error("Not a frame log: " + path);
+    }
+
+    std::size_t end = sizeof(FileHeader) + std::min<std::size_t>(header.dataSize, mappedSize_ - sizeof(FileHeader));
+    std::size_t offset = sizeof(FileHeader);
+    while (offset + sizeof(RecordHeader) <= end) {
+        RecordHeader recordHeader;
+        std::memcpy(&recordHeader, base_ + offset, sizeof(recordHeader));
+        std::size_t recordSize = paddedRecordSize(recordHeader.deviceIdSize, recordHeader.frameSize);
+        if (offset + recordSize > end) {
+            break; // Truncated record
+        }
+
+        const char* payload = reinterpret_cast<const char*>(base_ + offset + sizeof(RecordHeader));
+        FrameRecord record;
+        record.timestampNs = recordHeader.timestampNs;
+        record.wallClockNs = recordHeader.wallClockNs;
+        record.direction = static_cast<FrameDirection>(recordHeader.direction);
+        record.deviceId = std::string_view(payload, recordHeader.deviceIdSize);
+        record.frame = std::string_view(payload + recordHeader.deviceIdSize, recordHeader.frameSize);
+        deviceIndex_[record.deviceId].push_back(records_.size());
+        records_.push_back(record);
+        offset += recordSize;
+    }
+}
+
+FrameLogReader::~FrameLogReader() {
+    if (base_) {
+        ::munmap(const_cast<unsigned char*>(base_), mappedSize_);
+    }
+}
+
+const std::vector<std::size_t>& FrameLogReader::recordsForDevice(std::string_view deviceId) const {
+    static const std::vector<std::size_t> empty;
+    auto it = deviceIndex_.find(deviceId);
+    return it == deviceIndex_.end() ? empty : it->second;
+}
+
+std::size_t FrameLogReader::lowerBound(std::uint64_t timestampNs) const {
+    // Monotonic timestamps taken under the writer's lock are non-decreasing, even if the wall clock steps
+    auto it = std::lower_bound(records_.begin(), records_.end(), timestampNs,
+        [](const FrameRecord& record, std::uint64_t value) { return record.timestampNs < value; });
+    return static_cast<std::size_t>(it - records_.begin());
+}
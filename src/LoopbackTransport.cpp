@@ -0,0 +1,63 @@
+#include "LoopbackTransport.h"
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+// Channels whose readable callback is running on this thread, innermost last
+thread_local std::vector<const void*> callbackStack;
+
+} // namespace
+
+std::pair<std::unique_ptr<LoopbackTransport>, std::unique_ptr<LoopbackTransport>> LoopbackTransport::createPair() {
+    auto aToB = std::make_shared<Channel>();
+    auto bToA = std::make_shared<Channel>();
+    std::unique_ptr<LoopbackTransport> a(new LoopbackTransport(bToA, aToB));
+    std::unique_ptr<LoopbackTransport> b(new LoopbackTransport(aToB, bToA));
+    return std::make_pair(std::move(a), std::move(b));
+}
+
+LoopbackTransport::LoopbackTransport(std::shared_ptr<Channel> inbound, std::shared_ptr<Channel> outbound)
+    : inbound_(std::move(inbound)), outbound_(std::move(outbound)) {
+}
+
+bool LoopbackTransport::send(const std::string& /*deviceId*/, const std::string& frame) {
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(outbound_->mtx);
+        outbound_->frames.push_back(frame);
+        callback = outbound_->readableCallback;
+        if (callback) {
+            outbound_->runningCallbacks++;
+        }
+    }
+    // Notify outside the lock so the peer may send back from its callback
+    if (callback) {
+        callbackStack.push_back(outbound_.get());
+        callback();
+        callbackStack.pop_back();
+        std::lock_guard<std::mutex> lock(outbound_->mtx);
+        if (--outbound_->runningCallbacks == 0) {
+            outbound_->idle.notify_all();
+        }
+    }
+    return true;
+}
+
+bool LoopbackTransport::receive(std::string& frame) {
+    std::lock_guard<std::mutex> lock(inbound_->mtx);
+    if (inbound_->frames.empty()) {
+        return false;
+    }
+    frame = std::move(inbound_->frames.front());
+    inbound_->frames.pop_front();
+    return true;
+}
+
+void LoopbackTransport::setReadableCallback(std::function<void()> callback) {
+    std::unique_lock<std::mutex> lock(inbound_->mtx);
+    inbound_->readableCallback = std::move(callback);
+    // Wait for invocations on other threads; those this thread is inside of cannot finish first
+    auto own = static_cast<std::size_t>(std::count(callbackStack.begin(), callbackStack.end(), inbound_.get()));
+    inbound_->idle.wait(lock, [this, own]() { return inbound_->runningCallbacks <= own; });
+}
@@ -0,0 +1,119 @@
+#include "ReplayTransport.h"
+#include <chrono>
+
+ReplayTransport::ReplayTransport(const std::string& path, ReplaySpeed speed)
+    : log_(path), speed_(speed) {
+    for (std::size_t i = 0; i < log_.size(); ++i) {
+        if (log_.record(i).direction == FrameDirection::Received) {
+            frames_.push_back(i);
+        }
+    }
+}
+
+ReplayTransport::~ReplayTransport() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (pacer_.joinable()) {
+        pacer_.join();
+    }
+}
+
+void ReplayTransport::start() {
+    if (!pacer_.joinable()) {
+        pacer_ = std::thread([this]() { run(); });
+    }
+}
+
+void ReplayTransport::waitUntilFinished() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    cv_.wait(lock, [this]() { return finished_; });
+}
+
+void ReplayTransport::run() {
+    auto notify = [this]() {
+        std::function<void()> callback;
+        {
+            std::lock_guard<std::mutex> lock(mtx_);
+            callback = readableCallback_;
+            notifying_ = static_cast<bool>(callback);
+        }
+        if (callback) {
+            callback();
+            std::lock_guard<std::mutex> lock(mtx_);
+            notifying_ = false;
+            cv_.notify_all();
+        }
+    };
+
+    if (speed_ == ReplaySpeed::Maximum) {
+        released_ = frames_.size();
+        notify();
+    } else {
+        auto start = std::chrono::steady_clock::now();
+        std::uint64_t firstNs = frames_.empty() ? 0 : log_.record(frames_.front()).timestampNs;
+        for (std::size_t i = 0; i < frames_.size(); ++i) {
+            std::uint64_t timestampNs = log_.record(frames_[i]).timestampNs;
+            std::uint64_t offsetNs = timestampNs > firstNs ? timestampNs - firstNs : 0;
+            {
+                std::unique_lock<std::mutex> lock(mtx_);
+                if (cv_.wait_until(lock, start + std::chrono::nanoseconds(offsetNs), [this]() { return stopping_; })) {
+                    break;
+                }
+            }
+            released_ = i + 1;
+            notify();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    finished_ = true;
+    cv_.notify_all();
+}
+
+bool ReplayTransport::send(const std::string& /*deviceId*/, const std::string& /*frame*/) {
+    return true; // Nothing listens on the other side of a replay
+}
+
+bool ReplayTransport::receive(std::string& frame) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (consumed_ >= released_) {
+        return false;
+    }
+    std::string_view view = log_.record(frames_[consumed_++]).frame;
+    frame.assign(view.data(), view.size());
+    return true;
+}
+
+std::size_t ReplayTransport::drain(const std::function<void(const std::vector<std::string_view>&)>& handler) {
+    std::size_t first;
+    std::size_t last;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        first = consumed_;
+        last = released_;
+        consumed_ = last;
+    }
+    if (first == last) {
+        return 0;
+    }
+    // Records live in the mapping for the transport's lifetime, so views are handed out unlocked
+    std::vector<std::string_view> views;
+    views.reserve(last - first);
+    for (std::size_t i = first; i < last; ++i) {
+        views.push_back(log_.record(frames_[i]).frame);
+    }
+    handler(views);
+    return views.size();
+}
+
+void ReplayTransport::setReadableCallback(std::function<void()> callback) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    readableCallback_ = std::move(callback);
+    // The callback only runs on the pacing thread, which cannot wait for itself
+    if (std::this_thread::get_id() != pacer_.get_id()) {
+        cv_.wait(lock, [this]() { return !notifying_; });
+    }
+}
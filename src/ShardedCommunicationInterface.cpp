@@ -0,0 +1,159 @@
+#include "ShardedCommunicationInterface.h"
+#include "BlockingCall.h"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+ShardedCommunicationInterface::ShardedCommunicationInterface(std::size_t shardCount, SecurityFactory securityFactory,
+                                                             TransportFactory transportFactory) {
+    if (!securityFactory) {
+        throw std::invalid_argument("Security factory cannot be empty.");
+    }
+    shardCount = std::max<std::size_t>(shardCount, 1);
+    shards_.reserve(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        std::unique_ptr<ITransport> transport = transportFactory ? transportFactory(i) : nullptr;
+        ITransport* endpoint = transport.get();
+        auto comm = std::make_unique<CommunicationInterface>(securityFactory(i), std::move(transport));
+        // The console is the one resource every core would share, so shards do not echo commands to it
+        comm->setCommandEcho(false);
+        shards_.push_back(std::make_unique<Shard>(std::move(comm)));
+
+        // Replace the interface's own callback, which would process frames on the transport's thread:
+        // the transport thread only rings the doorbell, and the reactor drains
+        if (endpoint) {
+            Shard* shard = shards_.back().get();
+            endpoint->setReadableCallback([shard]() {
+                shard->readable.store(true, std::memory_order_release);
+                shard->doorbell.fetch_add(1, std::memory_order_release);
+                shard->doorbell.notify_one();
+            });
+        }
+    }
+
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        shards_[i]->comm->setDeviceScope([this, i](std::uint64_t handle) { return handle % shards_.size() == i; },
+                                         [this](std::string_view frame) { reroute(frame); });
+    }
+
+    std::size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        shards_[i]->reactor = std::thread(&ShardedCommunicationInterface::run, std::ref(*shards_[i]), i % cores);
+    }
+}
+
+ShardedCommunicationInterface::~ShardedCommunicationInterface() {
+    for (auto& shard : shards_) {
+        shard->stopping.store(true, std::memory_order_release);
+        shard->doorbell.fetch_add(1, std::memory_order_release);
+        shard->doorbell.notify_one();
+    }
+    for (auto& shard : shards_) {
+        shard->reactor.join();
+    }
+    // Detach every transport before any queue goes away, so late reroutes still find one
+    for (auto& shard : shards_) {
+        shard->comm.reset();
+    }
+}
+
+bool ShardedCommunicationInterface::sendControlCommand(const std::string& deviceId, const DataPacket::Command& command) {
+    return call(deviceId, [&deviceId, &command](CommunicationInterface& comm) {
+        return comm.sendControlCommand(deviceId, command);
+    });
+}
+
+bool ShardedCommunicationInterface::receiveState(const std::string& deviceId, DataPacket::State& state) {
+    bool received = call(deviceId, [&deviceId, &state](CommunicationInterface& comm) {
+        return comm.receiveState(deviceId, state);
+    });
+    // On the calling thread, so the callback may block on any shard without stalling a reactor
+    if (received) {
+        std::function<void(const DataPacket::State&)> callback;
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex_);
+            callback = stateCallback_;
+        }
+        if (callback) {
+            callback(state);
+        }
+    }
+    return received;
+}
+
+void ShardedCommunicationInterface::setStateCallback(std::function<void(const DataPacket::State&)> callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    stateCallback_ = callback;
+}
+
+std::size_t ShardedCommunicationInterface::shardOf(const std::string& deviceId) const {
+    return FrameHeader::deviceHandle(deviceId) % shards_.size();
+}
+
+void ShardedCommunicationInterface::post(Shard& shard, Job job) {
+    while (!shard.queue.tryPush(job)) {
+        std::this_thread::yield();
+    }
+    shard.doorbell.fetch_add(1, std::memory_order_release);
+    shard.doorbell.notify_one();
+}
+
+bool ShardedCommunicationInterface::call(const std::string& deviceId, std::function<bool(CommunicationInterface&)> job) {
+    Shard& shard = *shards_[shardOf(deviceId)];
+    return blockingCall([this, &shard](Job queued) { post(shard, std::move(queued)); },
+                        [&shard, &job]() { return job(*shard.comm); });
+}
+
+void ShardedCommunicationInterface::reroute(std::string_view frame) {
+    FrameHeader::Header header;
+    if (!FrameHeader::parse(frame, header)) {
+        return;
+    }
+    Shard& owner = *shards_[header.deviceHandle % shards_.size()];
+    Job job = [&owner, copy = std::string(frame)]() { owner.comm->ingestFrames({copy}); };
+    // Reroutes run on transport threads, which must never block on a busy shard
+    if (!owner.queue.tryPush(job)) {
+        std::cerr << "Shard queue full, dropping rerouted frame.\n";
+        return;
+    }
+    owner.doorbell.fetch_add(1, std::memory_order_release);
+    owner.doorbell.notify_one();
+}
+
+void ShardedCommunicationInterface::run(Shard& shard, std::size_t core) {
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(core, &cpus);
+    // Best effort: without permission to pin, the shard still runs, just unpinned
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    (void)core;
+#endif
+    Job job;
+    while (true) {
+        std::uint32_t seen = shard.doorbell.load(std::memory_order_acquire);
+        bool popped = shard.queue.tryPop(job);
+        // Checked after the pop: frames that became readable before the job was queued are processed first
+        bool drained = shard.readable.exchange(false, std::memory_order_acq_rel);
+        if (drained) {
+            shard.comm->drainTransport();
+        }
+        if (popped) {
+            job();
+            job = nullptr;
+            continue;
+        }
+        if (drained) {
+            continue;
+        }
+        if (shard.stopping.load(std::memory_order_acquire)) {
+            return;
+        }
+        shard.doorbell.wait(seen, std::memory_order_acquire);
+    }
+}
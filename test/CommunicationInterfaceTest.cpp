@@ -2,9 +2,26 @@
 #include "CommunicationInterface.h"
 #include "AESCBCSecurity.h"
 #include "DataPacket.h" 
+#include "LoopbackTransport.h"
+#include "ReplayTransport.h"
+#include "ShardedCommunicationInterface.h"
+#include "FrameLog.h"
+#include "FrameHeader.h"
+#include "Executor.h"
+#include "Task.h"
 #include <memory>
 #include <nlohmann/json.hpp>
 #include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <thread>
+#include <cstdint>
 
 // Pre-shared key : Since this is a test, we are using a hardcoded key
 std::string preSharedKeyHex = "00112233445566778899AABBCCDDEEFF";
@@ -145,6 +162,32 @@ TEST(CommunicationInterfaceTest, RQ005_EncryptDecrypt_Success) {
     EXPECT_EQ(decrypted, jsonStr); // Ensure decryption restores original data
 }
 
+// Test that batch decryption matches frame-by-frame decryption, including split batches and malformed frames
+TEST(CommunicationInterfaceTest, RQ011_DecryptBatch_MatchesDecrypt) {
+    // RQ-011: The system shall decrypt batches of incoming frames together
+    AESCBCSecurity security(preSharedKeyHex, 4);
+
+    std::vector<std::string> plainTexts;
+    std::vector<std::string> cipherTexts;
+    for (int i = 0; i < 5000; ++i) {
+        plainTexts.push_back(std::string(i % 97, static_cast<char>('a' + i % 26)));
+        cipherTexts.push_back(security.encrypt(plainTexts.back()));
+    }
+    std::string malformed = cipherTexts[1].substr(0, 20);
+
+    std::vector<std::string_view> batch(cipherTexts.begin(), cipherTexts.end());
+    batch.insert(batch.begin() + 2, malformed);
+
+    std::vector<std::string> decrypted = security.decryptBatch(batch);
+    ASSERT_EQ(decrypted.size(), batch.size());
+    EXPECT_TRUE(decrypted[2].empty()); // Malformed frame
+    decrypted.erase(decrypted.begin() + 2);
+    for (std::size_t i = 0; i < plainTexts.size(); ++i) {
+        ASSERT_EQ(decrypted[i], plainTexts[i]) << "frame " << i;
+        ASSERT_EQ(decrypted[i], security.decrypt(cipherTexts[i])) << "frame " << i;
+    }
+}
+
 // Test the full send and receive flow with encryption
 TEST(CommunicationInterfaceTest, RQ006_SendReceive_WithEncryption_Success) {
     // RQ-006: Integration test for sending and receiving data with encryption.
@@ -166,6 +209,973 @@ TEST(CommunicationInterfaceTest, RQ006_SendReceive_WithEncryption_Success) {
     EXPECT_EQ(state.value, 42);
 }
 
+// Helper function to build an authenticated State frame as a device would send it
+// (the default mask marks every command up to the acknowledgement as accepted)
+std::string makeStateFrame(ISecurity& security, const std::string& deviceId, std::uint64_t sequence, int value,
+                           std::uint64_t acknowledged = 0, std::uint64_t acknowledgedMask = ~std::uint64_t(0),
+                           std::uint64_t epoch = 1) {
+    nlohmann::json state;
+    state["deviceId"] = deviceId;
+    state["status"] = "DONE";
+    state["value"] = value;
+    return FrameHeader::seal(security, {FrameHeader::FrameType::State, FrameHeader::deviceHandle(deviceId), sequence, acknowledged, acknowledgedMask, epoch},
+                             security.encrypt(state.dump()));
+}
+
+// Simulated peer device: answers every command with a State frame whose value echoes the command speed
+// and acknowledges the commands its replay window has accepted
+class LoopbackPeer {
+public:
+    enum class ReplyMode {
+        Inline, // Reply from inside the send() that delivered the command
+        Held    // Keep replies until releaseReplies() sends them from another thread
+    };
+
+    explicit LoopbackPeer(std::unique_ptr<LoopbackTransport> endpoint, ReplyMode mode = ReplyMode::Inline)
+        : endpoint_(std::move(endpoint)), security_(preSharedKeyHex), mode_(mode) {
+        endpoint_->setReadableCallback([this]() { onReadable(); });
+    }
+    ~LoopbackPeer() {
+        if (replier_.joinable()) {
+            replier_.join();
+        }
+        endpoint_->setReadableCallback(nullptr);
+    }
+
+    std::size_t heldReplies() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return held_.size();
+    }
+
+    void releaseReplies() {
+        replier_ = std::thread([this]() {
+            std::vector<std::pair<std::string, std::string>> replies;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                replies.swap(held_);
+            }
+            for (const auto& [deviceId, reply] : replies) {
+                endpoint_->send(deviceId, reply);
+            }
+        });
+    }
+
+private:
+    void onReadable() {
+        std::string frame;
+        while (endpoint_->receive(frame)) {
+            FrameHeader::Header header;
+            if (!FrameHeader::parse(frame, header) || !FrameHeader::verify(security_, frame)) {
+                ADD_FAILURE() << "Peer received an unauthenticated frame";
+                continue;
+            }
+            if (header.type != FrameHeader::FrameType::Command) {
+                ADD_FAILURE() << "Peer received a frame that is not a Command frame";
+                continue;
+            }
+            nlohmann::json command = nlohmann::json::parse(security_.decrypt(FrameHeader::payload(frame)));
+            std::string deviceId = command.at("deviceId").get<std::string>();
+            std::uint64_t sequence;
+            std::uint64_t acknowledged;
+            std::uint64_t acknowledgedMask;
+            {
+                std::lock_guard<std::mutex> lock(mtx_);
+                sequence = ++sequences_[deviceId];
+                FrameHeader::ReplayWindow& window = commands_[deviceId];
+                if (window.check(header.epoch, header.sequence)) {
+                    window.update(header.epoch, header.sequence);
+                }
+                acknowledged = window.highest();
+                acknowledgedMask = window.seen();
+            }
+            std::string reply = makeStateFrame(security_, deviceId, sequence, command.at("speed").get<int>(), acknowledged,
+                                               acknowledgedMask);
+            if (mode_ == ReplyMode::Held) {
+                std::lock_guard<std::mutex> lock(mtx_);
+                held_.emplace_back(deviceId, std::move(reply));
+                continue;
+            }
+            endpoint_->send(deviceId, reply);
+        }
+    }
+
+    std::unique_ptr<LoopbackTransport> endpoint_;
+    AESCBCSecurity security_;
+    std::mutex mtx_;
+    std::unordered_map<std::string, std::uint64_t> sequences_;
+    std::unordered_map<std::string, FrameHeader::ReplayWindow> commands_; // Command sequence numbers accepted per device
+    ReplyMode mode_;
+    std::vector<std::pair<std::string, std::string>> held_; // Device ID and reply, in arrival order
+    std::thread replier_;
+};
+
+// Test thousands of concurrent send/await-state conversations over a few executor threads
+TEST(CommunicationInterfaceTest, RQ009_AsyncConversations_Loopback_Success) {
+    // RQ-009: The system shall provide awaitable send and receive methods resumed on an executor
+    // Declared first so it outlives the peer's reply thread, which posts resumptions to it
+    Executor executor(4);
+    auto endpoints = LoopbackTransport::createPair();
+    LoopbackPeer peer(std::move(endpoints.second), LoopbackPeer::ReplyMode::Held);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+
+    const int conversations = 10000;
+    std::atomic<int> succeeded{0};
+    int finished = 0;
+    std::mutex doneMtx;
+    std::condition_variable doneCv;
+
+    auto conversation = [&](int index) -> Task<void> {
+        std::string deviceId = "device" + std::to_string(index);
+        DataPacket::Command command;
+        command.commandName = "START";
+        command.speed = index % 1000;
+        command.duration = 1;
+
+        // Send the command and await the state
+        if (co_await comm.sendControlCommandAsync(executor, deviceId, command)) {
+            DataPacket::State state;
+            if (co_await comm.receiveStateAsync(executor, deviceId, state, std::chrono::seconds(60))) {
+                if (state.deviceId == deviceId && state.value == command.speed) {
+                    succeeded++;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(doneMtx);
+        if (++finished == conversations) {
+            doneCv.notify_all();
+        }
+    };
+
+    for (int i = 0; i < conversations; ++i) {
+        spawn(conversation(i));
+    }
+
+    // Every conversation parks in a waiter list before the peer sends a single reply
+    auto parkedReceives = [&comm]() {
+        std::lock_guard<std::mutex> lock(comm.inboxMutex_);
+        std::size_t parked = 0;
+        for (const auto& waiters : comm.waiters_) {
+            parked += waiters.second.size();
+        }
+        return parked;
+    };
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+    while (parkedReceives() < static_cast<std::size_t>(conversations) && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ASSERT_EQ(parkedReceives(), static_cast<std::size_t>(conversations));
+    EXPECT_EQ(peer.heldReplies(), static_cast<std::size_t>(conversations));
+
+    // Replies arrive on the peer's thread and resume the parked coroutines on the executor
+    peer.releaseReplies();
+    std::unique_lock<std::mutex> lock(doneMtx);
+    ASSERT_TRUE(doneCv.wait_for(lock, std::chrono::seconds(120), [&]() { return finished == conversations; }));
+    EXPECT_EQ(succeeded, conversations);
+}
+
+// Test that an awaited receive gives up once its timeout expires
+TEST(CommunicationInterfaceTest, RQ009_ReceiveStateAsync_Timeout) {
+    // RQ-009: The system shall provide awaitable send and receive methods resumed on an executor
+    auto endpoints = LoopbackTransport::createPair();
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    Executor executor(1);
+
+    std::mutex doneMtx;
+    std::condition_variable doneCv;
+    bool done = false;
+    bool received = true;
+
+    auto receive = [&]() -> Task<void> {
+        DataPacket::State state;
+        bool result = co_await comm.receiveStateAsync(executor, "device123", state, std::chrono::milliseconds(50));
+        std::lock_guard<std::mutex> lock(doneMtx);
+        received = result;
+        done = true;
+        doneCv.notify_all();
+    };
+    spawn(receive());
+
+    std::unique_lock<std::mutex> lock(doneMtx);
+    ASSERT_TRUE(doneCv.wait_for(lock, std::chrono::seconds(5), [&]() { return done; }));
+    EXPECT_FALSE(received);
+}
+
+// Test that a receive timeout still queued on the executor is harmless once the interface is gone
+TEST(CommunicationInterfaceTest, RQ009_ReceiveStateAsync_TimerOutlivesInterface) {
+    // RQ-009: The system shall provide awaitable send and receive methods resumed on an executor
+    Executor executor(1);
+    std::mutex doneMtx;
+    std::condition_variable doneCv;
+    bool done = false;
+    bool received = false;
+    {
+        auto endpoints = LoopbackTransport::createPair();
+        std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+        CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+
+        auto receive = [&]() -> Task<void> {
+            DataPacket::State state;
+            bool result = co_await comm.receiveStateAsync(executor, "device1", state, std::chrono::milliseconds(50));
+            std::lock_guard<std::mutex> lock(doneMtx);
+            received = result;
+            done = true;
+            doneCv.notify_all();
+        };
+        spawn(receive());
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        AESCBCSecurity deviceSecurity(preSharedKeyHex);
+        device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 1));
+
+        std::unique_lock<std::mutex> lock(doneMtx);
+        ASSERT_TRUE(doneCv.wait_for(lock, std::chrono::seconds(5), [&]() { return done; }));
+    }
+    EXPECT_TRUE(received);
+    // Delivery cancels the timeout; had it already been promoted, it would fire after the interface was destroyed
+    EXPECT_EQ(executor.pendingTimers(), 0u);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+// Test that cancelled delayed tasks never run and leave nothing queued
+TEST(CommunicationInterfaceTest, RQ009_Executor_CancelTimer) {
+    // RQ-009: The system shall provide awaitable send and receive methods resumed on an executor
+    Executor executor(2);
+    std::atomic<int> ran{0};
+    std::vector<Executor::TimerId> timers;
+    for (int i = 0; i < 1000; ++i) {
+        timers.push_back(executor.postAfter(std::chrono::milliseconds(50 + i % 10), [&ran]() { ran++; }));
+    }
+    Executor::TimerId kept = executor.postAfter(std::chrono::milliseconds(10), [&ran]() { ran += 1000; });
+    EXPECT_EQ(executor.pendingTimers(), 1001u);
+    for (Executor::TimerId timer : timers) {
+        EXPECT_TRUE(executor.cancel(timer));
+    }
+    EXPECT_FALSE(executor.cancel(timers.front()));
+    EXPECT_EQ(executor.pendingTimers(), 1u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(ran, 1000);
+    EXPECT_FALSE(executor.cancel(kept));
+    EXPECT_EQ(executor.pendingTimers(), 0u);
+}
+
+// Helper function to run a captured exchange of one command and one state per device
+void runCapturedExchange(const std::string& logPath, int devices) {
+    auto endpoints = LoopbackTransport::createPair();
+    LoopbackPeer peer(std::move(endpoints.second));
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    ASSERT_TRUE(comm.startCapture(logPath));
+
+    for (int i = 0; i < devices; ++i) {
+        DataPacket::Command command;
+        command.commandName = "CAPTURE";
+        command.speed = i;
+        command.duration = 1;
+        std::string deviceId = "device" + std::to_string(i);
+        ASSERT_TRUE(comm.sendControlCommand(deviceId, command));
+        DataPacket::State state;
+        ASSERT_TRUE(comm.receiveState(deviceId, state));
+    }
+    comm.stopCapture();
+}
+
+// Test that captured frames are indexed by device and replayed into a fresh interface
+TEST(CommunicationInterfaceTest, RQ010_CaptureReplay_MaximumSpeed_Success) {
+    // RQ-010: The system shall capture sent and received frames and replay them from the capture log
+    std::string logPath = ::testing::TempDir() + "rq010_capture.log";
+    runCapturedExchange(logPath, 10);
+
+    {
+        FrameLogReader reader(logPath);
+        ASSERT_EQ(reader.size(), 20u);
+        const auto& device3 = reader.recordsForDevice("device3");
+        ASSERT_EQ(device3.size(), 2u);
+        EXPECT_EQ(reader.record(device3[0]).direction, FrameDirection::Sent);
+        EXPECT_EQ(reader.record(device3[1]).direction, FrameDirection::Received);
+        EXPECT_EQ(reader.lowerBound(reader.record(device3[0]).timestampNs), device3[0]);
+        EXPECT_TRUE(reader.recordsForDevice("device999").empty());
+        for (std::size_t i = 1; i < reader.size(); ++i) {
+            EXPECT_LE(reader.record(i - 1).timestampNs, reader.record(i).timestampNs);
+            EXPECT_GT(reader.record(i).wallClockNs, 0u);
+        }
+    }
+
+    auto replay = std::make_unique<ReplayTransport>(logPath, ReplaySpeed::Maximum);
+    ReplayTransport* replayTransport = replay.get();
+    EXPECT_EQ(replayTransport->frameCount(), 10u);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(replay));
+    replayTransport->start();
+    replayTransport->waitUntilFinished();
+
+    for (int i = 0; i < 10; ++i) {
+        DataPacket::State state;
+        std::string deviceId = "device" + std::to_string(i);
+        ASSERT_TRUE(comm.receiveState(deviceId, state));
+        EXPECT_EQ(state.deviceId, deviceId);
+        EXPECT_EQ(state.status, "DONE");
+        EXPECT_EQ(state.value, i);
+    }
+    std::remove(logPath.c_str());
+}
+
+// Test that replaying at original speed delivers every captured state
+TEST(CommunicationInterfaceTest, RQ010_CaptureReplay_OriginalSpeed_Success) {
+    // RQ-010: The system shall capture sent and received frames and replay them from the capture log
+    std::string logPath = ::testing::TempDir() + "rq010_original.log";
+    runCapturedExchange(logPath, 3);
+
+    auto replay = std::make_unique<ReplayTransport>(logPath, ReplaySpeed::Original);
+    ReplayTransport* replayTransport = replay.get();
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(replay));
+    replayTransport->start();
+    replayTransport->waitUntilFinished();
+
+    DataPacket::State state;
+    EXPECT_TRUE(comm.receiveState("device0", state));
+    EXPECT_TRUE(comm.receiveState("device1", state));
+    EXPECT_TRUE(comm.receiveState("device2", state));
+    EXPECT_FALSE(comm.receiveState("device2", state));
+    std::remove(logPath.c_str());
+}
+
+// Security module that counts decryptions, to prove rejected frames never reach the cipher
+class CountingSecurity : public ISecurity {
+public:
+    CountingSecurity() : inner_(preSharedKeyHex) {}
+
+    std::string encrypt(const std::string& plainText) override { return inner_.encrypt(plainText); }
+    std::string decrypt(std::string_view cipherText) override {
+        decrypted++;
+        decryptThread = std::this_thread::get_id();
+        return inner_.decrypt(cipherText);
+    }
+    std::vector<std::string> decryptBatch(const std::vector<std::string_view>& cipherTexts) override {
+        decrypted += static_cast<int>(cipherTexts.size());
+        decryptThread = std::this_thread::get_id();
+        return inner_.decryptBatch(cipherTexts);
+    }
+    std::string authenticate(std::string_view message) override { return inner_.authenticate(message); }
+    bool verify(std::string_view message, std::string_view tag) override { return inner_.verify(message, tag); }
+
+    std::atomic<int> decrypted{0};
+    std::atomic<std::thread::id> decryptThread; // Thread of the most recent decryption
+
+private:
+    AESCBCSecurity inner_;
+};
+
+// Test that replayed, forged and out-of-scope frames are rejected on the header alone
+TEST(CommunicationInterfaceTest, RQ012_FrameHeader_RejectsBeforeDecryption) {
+    // RQ-012: The system shall reject misrouted, replayed and forged frames before decrypting them
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    auto security = std::make_unique<CountingSecurity>();
+    CountingSecurity* counter = security.get();
+    CommunicationInterface comm(std::move(security), std::move(endpoints.first));
+
+    std::vector<std::string> rerouted;
+    std::uint64_t ownHandle = FrameHeader::deviceHandle("device1");
+    comm.setDeviceScope([ownHandle](std::uint64_t handle) { return handle == ownHandle; },
+                        [&rerouted](std::string_view frame) { rerouted.emplace_back(frame); });
+
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    std::string frame = makeStateFrame(deviceSecurity, "device1", 1, 7);
+    device->send("device1", frame);
+    EXPECT_EQ(counter->decrypted, 1);
+
+    // Replay of an accepted frame
+    device->send("device1", frame);
+    // Forged payload: tag no longer matches
+    std::string forged = makeStateFrame(deviceSecurity, "device1", 2, 8);
+    forged.back() ^= 0x01;
+    device->send("device1", forged);
+    // Frame for a device outside this interface's scope
+    device->send("device2", makeStateFrame(deviceSecurity, "device2", 1, 9));
+    EXPECT_EQ(counter->decrypted, 1);
+    ASSERT_EQ(rerouted.size(), 1u);
+
+    DataPacket::State state;
+    EXPECT_TRUE(comm.receiveState("device1", state));
+    EXPECT_EQ(state.value, 7);
+    EXPECT_FALSE(comm.receiveState("device1", state));
+    EXPECT_FALSE(comm.receiveState("device2", state));
+
+    // A reordered but unseen sequence number within the window is still accepted
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 5, 10));
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 3, 11));
+    EXPECT_TRUE(comm.receiveState("device1", state));
+    EXPECT_EQ(state.value, 10);
+    EXPECT_TRUE(comm.receiveState("device1", state));
+    EXPECT_EQ(state.value, 11);
+}
+
+// Test that a Command frame reflected back to the host is rejected before it touches the device's replay window
+TEST(CommunicationInterfaceTest, RQ012_FrameHeader_RejectsReflectedCommand) {
+    // RQ-012: The system shall reject misrouted, replayed and forged frames before decrypting them
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    auto security = std::make_unique<CountingSecurity>();
+    CountingSecurity* counter = security.get();
+    CommunicationInterface comm(std::move(security), std::move(endpoints.first));
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    DataPacket::State state;
+
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 1));
+    ASSERT_TRUE(comm.receiveState("device1", state));
+
+    // The command carries the host's own, newer epoch and a valid tag under the shared key
+    DataPacket::Command command{"MOVE", 10, 1};
+    ASSERT_TRUE(comm.sendControlCommand("device1", command));
+    std::string reflected;
+    ASSERT_TRUE(device->receive(reflected));
+    int decrypted = counter->decrypted;
+    device->send("device1", reflected);
+    EXPECT_EQ(counter->decrypted, decrypted);
+    EXPECT_FALSE(comm.receiveState("device1", state));
+
+    // The device's session is unaffected
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 2, 2));
+    ASSERT_TRUE(comm.receiveState("device1", state));
+    EXPECT_EQ(state.value, 2);
+}
+
+// Test that session epochs let a rebooted device restart its sequence numbers without reopening old sessions
+TEST(CommunicationInterfaceTest, RQ012_FrameHeader_SessionEpochs) {
+    // RQ-012: The system shall reject misrouted, replayed and forged frames before decrypting them
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    DataPacket::State state;
+
+    std::string beforeReboot = makeStateFrame(deviceSecurity, "device1", 40, 1, 0, 0, 1);
+    device->send("device1", beforeReboot);
+    EXPECT_TRUE(comm.receiveState("device1", state));
+
+    // The rebooted device starts again at sequence number 1 in a newer epoch
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 2, 0, 0, 2));
+    EXPECT_TRUE(comm.receiveState("device1", state));
+    EXPECT_EQ(state.value, 2);
+
+    // Frames of the previous session, captured or delayed, are rejected from then on
+    device->send("device1", beforeReboot);
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 41, 3, 0, 0, 1));
+    EXPECT_FALSE(comm.receiveState("device1", state));
+
+    // A restarted interface seals its commands in a newer epoch, so the device accepts sequence number 1 again
+    FrameHeader::ReplayWindow deviceWindow;
+    DataPacket::Command command{"MOVE", 10, 1};
+    std::string frame;
+    FrameHeader::Header header;
+    ASSERT_TRUE(comm.sendControlCommand("device1", command));
+    ASSERT_TRUE(device->receive(frame));
+    ASSERT_TRUE(FrameHeader::parse(frame, header));
+    EXPECT_EQ(header.sequence, 1u);
+    ASSERT_TRUE(deviceWindow.check(header.epoch, header.sequence));
+    deviceWindow.update(header.epoch, header.sequence);
+    std::uint64_t firstEpoch = header.epoch;
+
+    auto restarted = LoopbackTransport::createPair();
+    CommunicationInterface restartedComm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(restarted.first));
+    ASSERT_TRUE(restartedComm.sendControlCommand("device1", command));
+    ASSERT_TRUE(restarted.second->receive(frame));
+    ASSERT_TRUE(FrameHeader::parse(frame, header));
+    EXPECT_EQ(header.sequence, 1u);
+    EXPECT_GT(header.epoch, firstEpoch);
+    EXPECT_TRUE(deviceWindow.check(header.epoch, header.sequence));
+}
+
+// Test that many tracked commands are pipelined to a device and completed by piggy-backed acknowledgements
+TEST(CommunicationInterfaceTest, RQ013_PipelinedCommands_Acknowledged) {
+    // RQ-013: The system shall pipeline sequence-numbered commands within a per-device window and track their acknowledgement
+    auto endpoints = LoopbackTransport::createPair();
+    LoopbackPeer peer(std::move(endpoints.second));
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+
+    std::mutex mtx;
+    std::vector<std::uint64_t> acknowledged;
+    comm.setCommandCallback([&](const std::string& deviceId, std::uint64_t sequence, CommandStatus status) {
+        EXPECT_EQ(deviceId, "device1");
+        EXPECT_EQ(status, CommandStatus::Acknowledged);
+        std::lock_guard<std::mutex> lock(mtx);
+        acknowledged.push_back(sequence);
+    });
+
+    DataPacket::Command command;
+    command.commandName = "MOVE";
+    command.duration = 1;
+    std::vector<std::uint64_t> sequences;
+    for (int i = 0; i < 100; ++i) {
+        command.speed = i;
+        std::uint64_t sequence = comm.sendTrackedCommand("device1", command);
+        ASSERT_NE(sequence, 0u);
+        sequences.push_back(sequence);
+        DataPacket::State state;
+        ASSERT_TRUE(comm.receiveState("device1", state));
+        EXPECT_EQ(state.value, i);
+    }
+    EXPECT_EQ(sequences.back(), 100u);
+    for (std::uint64_t sequence : sequences) {
+        EXPECT_EQ(comm.commandStatus("device1", sequence), CommandStatus::Acknowledged);
+    }
+    std::lock_guard<std::mutex> lock(mtx);
+    EXPECT_EQ(acknowledged, sequences);
+}
+
+// Test the in-flight window, retransmission on timeout and failure after the retransmission limit
+TEST(CommunicationInterfaceTest, RQ013_PipelinedCommands_WindowAndRetransmit) {
+    // RQ-013: The system shall pipeline sequence-numbered commands within a per-device window and track their acknowledgement
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    comm.setCommandWindow(8, std::chrono::milliseconds(20), 1);
+
+    std::vector<CommandTracker::Completion> completions;
+    comm.setCommandCallback([&](const std::string& deviceId, std::uint64_t sequence, CommandStatus status) {
+        completions.push_back({deviceId, sequence, status});
+    });
+
+    // Collects the sequence numbers of the command frames that reached the device
+    auto receivedSequences = [&device]() {
+        std::vector<std::uint64_t> sequences;
+        std::string frame;
+        FrameHeader::Header header;
+        while (device->receive(frame)) {
+            EXPECT_TRUE(FrameHeader::parse(frame, header));
+            sequences.push_back(header.sequence);
+        }
+        return sequences;
+    };
+
+    DataPacket::Command command{"MOVE", 10, 1};
+    for (std::uint64_t i = 1; i <= 8; ++i) {
+        EXPECT_EQ(comm.sendTrackedCommand("device1", command), i);
+    }
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 0u); // Window full
+    EXPECT_EQ(receivedSequences(), (std::vector<std::uint64_t>{1, 2, 3, 4, 5, 6, 7, 8}));
+
+    // A State frame acknowledging 5 completes 1..5 and frees their slots
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 0, 5));
+    ASSERT_EQ(completions.size(), 5u);
+    EXPECT_EQ(completions.back().sequence, 5u);
+    EXPECT_EQ(completions.back().status, CommandStatus::Acknowledged);
+    EXPECT_EQ(comm.commandStatus("device1", 5), CommandStatus::Acknowledged);
+    EXPECT_EQ(comm.commandStatus("device1", 6), CommandStatus::Pending);
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 9u);
+    receivedSequences();
+
+    // Overdue commands are resent unchanged, then failed once the retransmission limit is reached
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(comm.retransmitExpired(), 4u);
+    EXPECT_EQ(receivedSequences(), (std::vector<std::uint64_t>{6, 7, 8, 9}));
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 2, 0, 7));
+    EXPECT_EQ(completions.size(), 7u);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(comm.retransmitExpired(), 0u);
+    ASSERT_EQ(completions.size(), 9u);
+    EXPECT_EQ(completions.back().status, CommandStatus::Failed);
+    EXPECT_EQ(comm.commandStatus("device1", 8), CommandStatus::Failed);
+    EXPECT_EQ(comm.commandStatus("device1", 9), CommandStatus::Failed);
+    EXPECT_EQ(comm.commandStatus("device1", 10), CommandStatus::Unknown);
+}
+
+// Test that a new retransmission policy applies to later commands only
+TEST(CommunicationInterfaceTest, RQ013_PipelinedCommands_PolicyKeptInFlight) {
+    // RQ-013: The system shall pipeline sequence-numbered commands within a per-device window and track their acknowledgement
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    comm.setCommandWindow(8, std::chrono::milliseconds(20), 0);
+
+    std::vector<CommandTracker::Completion> completions;
+    comm.setCommandCallback([&](const std::string& deviceId, std::uint64_t sequence, CommandStatus status) {
+        completions.push_back({deviceId, sequence, status});
+    });
+
+    DataPacket::Command command{"MOVE", 10, 1};
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 1u);
+    comm.setCommandWindow(8, std::chrono::milliseconds(20), 1);
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 2u);
+
+    // Command 1 was sent without retransmissions and fails; command 2 is resent
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(comm.retransmitExpired(), 1u);
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions.back().sequence, 1u);
+    EXPECT_EQ(completions.back().status, CommandStatus::Failed);
+    EXPECT_EQ(comm.commandStatus("device1", 2), CommandStatus::Pending);
+}
+
+// Test that a failed command does not hold back the acknowledgement of later commands
+TEST(CommunicationInterfaceTest, RQ013_PipelinedCommands_SelectiveAckAfterFailure) {
+    // RQ-013: The system shall pipeline sequence-numbered commands within a per-device window and track their acknowledgement
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    comm.setCommandWindow(8, std::chrono::milliseconds(20), 0);
+
+    std::vector<CommandTracker::Completion> completions;
+    comm.setCommandCallback([&](const std::string& deviceId, std::uint64_t sequence, CommandStatus status) {
+        completions.push_back({deviceId, sequence, status});
+    });
+
+    // The device acknowledges with its replay window, as LoopbackPeer does
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    FrameHeader::ReplayWindow window;
+    std::uint64_t stateSequence = 0;
+    auto deliverAndAcknowledge = [&]() {
+        std::string frame;
+        FrameHeader::Header header;
+        while (device->receive(frame)) {
+            ASSERT_TRUE(FrameHeader::parse(frame, header));
+            window.update(header.epoch, header.sequence);
+        }
+        device->send("device1", makeStateFrame(deviceSecurity, "device1", ++stateSequence, 0, window.highest(), window.seen()));
+    };
+
+    // Command 1 is lost and fails without retransmission
+    DataPacket::Command command{"MOVE", 10, 1};
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 1u);
+    std::string lost;
+    FrameHeader::Header lostHeader;
+    ASSERT_TRUE(device->receive(lost));
+    ASSERT_TRUE(FrameHeader::parse(lost, lostHeader));
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    EXPECT_EQ(comm.retransmitExpired(), 0u);
+    ASSERT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions.back().status, CommandStatus::Failed);
+
+    // An untracked command takes sequence number 2 from the same space; the tracked command 3 is still acknowledged
+    ASSERT_TRUE(comm.sendControlCommand("device1", command));
+    EXPECT_EQ(comm.sendTrackedCommand("device1", command), 3u);
+    deliverAndAcknowledge();
+    ASSERT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions.back().sequence, 3u);
+    EXPECT_EQ(completions.back().status, CommandStatus::Acknowledged);
+    EXPECT_EQ(comm.commandStatus("device1", 3), CommandStatus::Acknowledged);
+
+    // A late delivery of the failed command does not change its reported status
+    window.update(lostHeader.epoch, lostHeader.sequence);
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", ++stateSequence, 0, window.highest(), window.seen()));
+    EXPECT_EQ(completions.size(), 2u);
+    EXPECT_EQ(comm.commandStatus("device1", 1), CommandStatus::Failed);
+    EXPECT_EQ(comm.commandStatus("device1", 2), CommandStatus::Unknown);
+}
+
+// Test that a command callback may send through the interface that reported the completion
+TEST(CommunicationInterfaceTest, RQ013_CommandCallback_CallsBack) {
+    // RQ-013: The system shall pipeline sequence-numbered commands within a per-device window and track their acknowledgement
+    DataPacket::Command command{"MOVE", 10, 1};
+
+    // Acknowledged by a placeholder frame taken inside receiveState
+    auto comm = createCommInterface();
+    ASSERT_NE(comm, nullptr);
+    int placeholderCalls = 0;
+    bool sentFromPlaceholder = false;
+    comm->setCommandCallback([&](const std::string& deviceId, std::uint64_t, CommandStatus status) {
+        EXPECT_EQ(status, CommandStatus::Acknowledged);
+        placeholderCalls++;
+        sentFromPlaceholder = comm->sendControlCommand(deviceId, command);
+    });
+    ASSERT_EQ(comm->sendTrackedCommand("device123", command), 1u);
+    DataPacket::State state;
+    ASSERT_TRUE(comm->receiveState("device123", state));
+    EXPECT_EQ(placeholderCalls, 1);
+    EXPECT_TRUE(sentFromPlaceholder);
+
+    // Acknowledged by a reply the transport delivers inline, inside a blocking sendControlCommand
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface linked(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    FrameHeader::ReplayWindow window;
+    std::uint64_t stateSequence = 0;
+    std::atomic<bool> replying{false};
+    device->setReadableCallback([&]() {
+        if (!replying) {
+            return; // Leave the tracked command queued until the next command arrives
+        }
+        std::string frame;
+        FrameHeader::Header header;
+        while (device->receive(frame)) {
+            ASSERT_TRUE(FrameHeader::parse(frame, header));
+            window.update(header.epoch, header.sequence);
+        }
+        device->send("device1", makeStateFrame(deviceSecurity, "device1", ++stateSequence, 0, window.highest(), window.seen()));
+    });
+
+    int inlineCalls = 0;
+    bool sentFromInline = false;
+    linked.setCommandCallback([&](const std::string& deviceId, std::uint64_t sequence, CommandStatus status) {
+        EXPECT_EQ(sequence, 1u);
+        EXPECT_EQ(status, CommandStatus::Acknowledged);
+        inlineCalls++;
+        sentFromInline = linked.sendControlCommand(deviceId, command);
+    });
+    ASSERT_EQ(linked.sendTrackedCommand("device1", command), 1u);
+    replying = true;
+    EXPECT_TRUE(linked.sendControlCommand("device1", command));
+    EXPECT_EQ(inlineCalls, 1);
+    EXPECT_TRUE(sentFromInline);
+    EXPECT_EQ(linked.commandStatus("device1", 1), CommandStatus::Acknowledged);
+    device->setReadableCallback(nullptr);
+}
+
+// Transport whose sends to one device block until released, standing in for a saturated bulk link
+class StalledTransport : public ITransport {
+public:
+    explicit StalledTransport(std::string stalledDevice) : stalledDevice_(std::move(stalledDevice)) {}
+
+    bool send(const std::string& deviceId, const std::string& /*frame*/) override {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (deviceId == stalledDevice_) {
+            stalled_++;
+            cv_.notify_all();
+            cv_.wait(lock, [this]() { return released_; });
+        }
+        sent_.push_back(deviceId);
+        return true;
+    }
+    bool receive(std::string& /*frame*/) override { return false; }
+    void setReadableCallback(std::function<void()> /*callback*/) override {}
+
+    void waitUntilStalled() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this]() { return stalled_ > 0; });
+    }
+    void release() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        released_ = true;
+        cv_.notify_all();
+    }
+    std::vector<std::string> sent() {
+        std::lock_guard<std::mutex> lock(mtx_);
+        return sent_;
+    }
+
+private:
+    std::string stalledDevice_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    int stalled_ = 0;
+    bool released_ = false;
+    std::vector<std::string> sent_;
+};
+
+// Test that an urgent command is sent while the bulk lane is stalled with queued commands
+TEST(CommunicationInterfaceTest, RQ014_UrgentCommand_BypassesBulkLane) {
+    // RQ-014: The system shall send urgent commands on a dedicated lane that never waits behind bulk commands
+    auto transport = std::make_unique<StalledTransport>("bulkDevice");
+    StalledTransport* link = transport.get();
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(transport));
+
+    std::vector<std::thread> bulkSenders;
+    for (int i = 0; i < 3; ++i) {
+        bulkSenders.emplace_back([&comm]() {
+            DataPacket::Command configure{"CONFIGURE", 10, 1000};
+            EXPECT_TRUE(comm.sendControlCommand("bulkDevice", configure, CommandPriority::Bulk));
+        });
+    }
+    link->waitUntilStalled();
+
+    DataPacket::Command stop{"STOP", 0, 1};
+    EXPECT_TRUE(comm.sendControlCommand("stopDevice", stop, CommandPriority::Urgent));
+    EXPECT_EQ(link->sent(), std::vector<std::string>{"stopDevice"});
+
+    DataPacket::Command invalid{"", 0, 0};
+    EXPECT_FALSE(comm.sendControlCommand("stopDevice", invalid, CommandPriority::Urgent));
+
+    link->release();
+    for (auto& sender : bulkSenders) {
+        sender.join();
+    }
+    EXPECT_EQ(link->sent().size(), 4u);
+}
+
+// Test that urgent commands never write to the console, even through the placeholder send path
+TEST(CommunicationInterfaceTest, RQ014_UrgentCommand_NotEchoed) {
+    // RQ-014: The system shall send urgent commands on a dedicated lane that never waits behind bulk commands
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex));
+
+    DataPacket::Command stop{"STOP", 0, 1};
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(comm.sendControlCommand("stopDevice", stop, CommandPriority::Urgent));
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+
+    testing::internal::CaptureStdout();
+    EXPECT_TRUE(comm.sendControlCommand("bulkDevice", stop, CommandPriority::Bulk));
+    EXPECT_NE(testing::internal::GetCapturedStdout().find("Sending Encrypted Data to Device [bulkDevice]"), std::string::npos);
+}
+
+// Test that devices are served by their own shard and that frames arriving on another shard are rerouted
+TEST(CommunicationInterfaceTest, RQ015_ShardedInterface_RoutesByDevice) {
+    // RQ-015: The system shall partition devices across shards that share no state and hand work over through lock-free queues
+    std::vector<std::unique_ptr<LoopbackTransport>> devices;
+    std::vector<CountingSecurity*> securities;
+    ShardedCommunicationInterface comm(
+        4, [&securities](std::size_t) {
+            auto security = std::make_unique<CountingSecurity>();
+            securities.push_back(security.get());
+            return security;
+        },
+        [&devices](std::size_t) {
+            auto endpoints = LoopbackTransport::createPair();
+            devices.push_back(std::move(endpoints.second));
+            return std::move(endpoints.first);
+        });
+    ASSERT_EQ(comm.shardCount(), 4u);
+    ASSERT_EQ(devices.size(), 4u);
+
+    // A rerouted frame reaches its owner after two reactor hops, so poll for it
+    auto receiveWithin = [&comm](const std::string& deviceId, DataPacket::State& state) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (!comm.receiveState(deviceId, state)) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    };
+
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    DataPacket::Command command{"MOVE", 10, 1};
+    for (int i = 0; i < 16; ++i) {
+        std::string deviceId = "device" + std::to_string(i);
+        std::size_t owner = comm.shardOf(deviceId);
+
+        // Commands leave through the owning shard's endpoint
+        EXPECT_TRUE(comm.sendControlCommand(deviceId, command));
+        std::string frame;
+        ASSERT_TRUE(devices[owner]->receive(frame));
+        FrameHeader::Header header;
+        ASSERT_TRUE(FrameHeader::parse(frame, header));
+        EXPECT_EQ(header.deviceHandle, FrameHeader::deviceHandle(deviceId));
+
+        // A state sent to the owner's endpoint is decrypted on the owner's reactor, not the sending thread,
+        // and is ready for a call queued after it arrived
+        devices[owner]->send(deviceId, makeStateFrame(deviceSecurity, deviceId, 1, i));
+        DataPacket::State state;
+        ASSERT_TRUE(comm.receiveState(deviceId, state));
+        EXPECT_EQ(state.value, i);
+        EXPECT_NE(securities[owner]->decryptThread.load(), std::this_thread::get_id());
+
+        // A state sent to a different shard's endpoint is handed to the owner before decryption
+        std::size_t other = (owner + 1) % devices.size();
+        int decryptedByOther = securities[other]->decrypted;
+        devices[other]->send(deviceId, makeStateFrame(deviceSecurity, deviceId, 2, i + 100));
+        ASSERT_TRUE(receiveWithin(deviceId, state));
+        EXPECT_EQ(state.deviceId, deviceId);
+        EXPECT_EQ(state.value, i + 100);
+        EXPECT_EQ(securities[other]->decrypted, decryptedByOther);
+        EXPECT_FALSE(comm.receiveState(deviceId, state));
+    }
+}
+
+// Test that a state callback runs on the receiving thread and may call into any shard
+TEST(CommunicationInterfaceTest, RQ015_ShardedInterface_CallbackCallsBack) {
+    // RQ-015: The system shall partition devices across shards that share no state and hand work over through lock-free queues
+    std::vector<std::unique_ptr<LoopbackTransport>> devices;
+    ShardedCommunicationInterface comm(
+        2, [](std::size_t) { return std::make_unique<AESCBCSecurity>(preSharedKeyHex); },
+        [&devices](std::size_t) {
+            auto endpoints = LoopbackTransport::createPair();
+            devices.push_back(std::move(endpoints.second));
+            return std::move(endpoints.first);
+        });
+
+    // One device on each shard
+    std::string local = "device0";
+    std::string remote = "device1";
+    while (comm.shardOf(remote) == comm.shardOf(local)) {
+        remote += "x";
+    }
+
+    DataPacket::Command command{"MOVE", 10, 1};
+    bool sentLocal = false;
+    bool sentRemote = false;
+    std::thread::id callbackThread;
+    comm.setStateCallback([&](const DataPacket::State&) {
+        callbackThread = std::this_thread::get_id();
+        sentLocal = comm.sendControlCommand(local, command);
+        sentRemote = comm.sendControlCommand(remote, command);
+    });
+
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    devices[comm.shardOf(local)]->send(local, makeStateFrame(deviceSecurity, local, 1, 1));
+    DataPacket::State state;
+    ASSERT_TRUE(comm.receiveState(local, state));
+    EXPECT_EQ(callbackThread, std::this_thread::get_id());
+    EXPECT_TRUE(sentLocal);
+    EXPECT_TRUE(sentRemote);
+}
+
+// Test that a blocking receive sleeps until the transport delivers a state, or until its deadline
+TEST(CommunicationInterfaceTest, RQ016_BlockingReceive_WakesOnArrival) {
+    // RQ-016: The system shall block a receive until a state for the device arrives or a deadline passes, without polling
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    DataPacket::State state;
+
+    // Nothing arrives: the receive gives up once the timeout has elapsed
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(comm.receiveState("device1", state, std::chrono::milliseconds(50)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+
+    // A state arriving while the receiver sleeps wakes it well before its deadline
+    std::thread sender([&device, &deviceSecurity]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 5));
+    });
+    start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(comm.receiveState("device1", state, start + std::chrono::seconds(10)));
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_EQ(state.value, 5);
+    sender.join();
+
+    // A state already delivered is returned without waiting
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 2, 6));
+    EXPECT_TRUE(comm.receiveState("device1", state, std::chrono::steady_clock::now()));
+    EXPECT_EQ(state.value, 6);
+}
+
+// Test that waitAny returns the first state delivered for any of the devices
+TEST(CommunicationInterfaceTest, RQ016_WaitAny_ReturnsFirstReadyState) {
+    // RQ-016: The system shall block a receive until a state for the device arrives or a deadline passes, without polling
+    auto endpoints = LoopbackTransport::createPair();
+    std::unique_ptr<LoopbackTransport> device = std::move(endpoints.second);
+    CommunicationInterface comm(std::make_unique<AESCBCSecurity>(preSharedKeyHex), std::move(endpoints.first));
+    AESCBCSecurity deviceSecurity(preSharedKeyHex);
+    std::vector<std::string> devices{"device1", "device2", "device3"};
+    DataPacket::State state;
+
+    // A state for a device outside the list does not wake the caller
+    device->send("device4", makeStateFrame(deviceSecurity, "device4", 1, 4));
+    EXPECT_FALSE(comm.waitAny(devices, state, std::chrono::milliseconds(20)));
+
+    std::thread sender([&device, &deviceSecurity]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        device->send("device2", makeStateFrame(deviceSecurity, "device2", 1, 2));
+    });
+    EXPECT_TRUE(comm.waitAny(devices, state, std::chrono::seconds(10)));
+    EXPECT_EQ(state.deviceId, "device2");
+    EXPECT_EQ(state.value, 2);
+    sender.join();
+
+    // With states pending for several devices, the first listed device wins
+    device->send("device3", makeStateFrame(deviceSecurity, "device3", 1, 3));
+    device->send("device1", makeStateFrame(deviceSecurity, "device1", 1, 1));
+    EXPECT_TRUE(comm.waitAny(devices, state, std::chrono::milliseconds(0)));
+    EXPECT_EQ(state.deviceId, "device1");
+    EXPECT_TRUE(comm.waitAny(devices, state, std::chrono::milliseconds(0)));
+    EXPECT_EQ(state.deviceId, "device3");
+    EXPECT_TRUE(comm.receiveState("device4", state));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();